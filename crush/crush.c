@@ -1,17 +1,35 @@
+#define _POSIX_C_SOURCE 200809L
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
-#include <ctype.h>
 #include <math.h>
+#include <float.h>
+#include <stdint.h>
 #include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <pthread.h>
 #include "crush.h"
+#include "pow5.h"
+#include "keywords.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CRUSH_X86 1
+#include <immintrin.h>
+#endif
 
 // http://dev.w3.org/csswg/css-syntax/#tokenizing-and-parsing-css
 
-const static unsigned BUFFER_INIT_MAX = 32;
+// Most decoded values are short idents, so a token keeps a few bytes inline
+// and only allocates for longer ones.
+enum { BUFFER_INIT_MAX = 16 };
 #define NEVER_RETURN() {assert(0); return 0;}
 #define null NULL
+#define COUNT(array) (sizeof(array) / sizeof((array)[0]))
 
 // Code point
 typedef int cp;
@@ -27,11 +45,111 @@ static void* zmalloc(size_t size) {
     return result;
 }
 
+static void* zrealloc(void* data, size_t size) {
+    void* result = realloc(data, size);
+    if (!result) {
+        fprintf(stderr, "Error allocating memory");
+        exit(EXIT_FAILURE);
+    }
+    return result;
+}
+
+// Bump allocator for the tokens a parse creates and their grown buffers.
+// Nothing is freed individually; the blocks are released together by
+// arena_free.
+enum { ARENA_BLOCK_SIZE = 64 * 1024, ARENA_ALIGN = 16 };
+
+struct arena_block {
+    struct arena_block* next;
+    size_t size;
+    size_t used;
+    unsigned char data[];
+};
+
+struct arena {
+    struct arena_block* head;
+    size_t allocations; // objects handed out
+    size_t blocks;      // calls to malloc
+    size_t bytes;       // total size of the blocks
+};
+
+static struct arena* arena_new(void) {
+    return zmalloc(sizeof(struct arena));
+}
+
+static struct arena_block* arena_add_block(struct arena* a, size_t size) {
+    struct arena_block* block = malloc(sizeof(struct arena_block) + size);
+    if (!block) {
+        fprintf(stderr, "Error allocating memory");
+        exit(EXIT_FAILURE);
+    }
+    block->size = size;
+    block->used = 0;
+    a->blocks++;
+    a->bytes += size;
+
+    // Keep filling the current block after an oversized allocation.
+    if (a->head && size > ARENA_BLOCK_SIZE) {
+        block->next = a->head->next;
+        a->head->next = block;
+    } else {
+        block->next = a->head;
+        a->head = block;
+    }
+    return block;
+}
+
+// Zeroed memory that lives as long as the arena.
+static void* arena_alloc(struct arena* a, size_t size) {
+    size = (size + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+    a->allocations++;
+
+    struct arena_block* block = a->head;
+    if (!block || block->size - block->used < size) {
+        block = arena_add_block(a, size > ARENA_BLOCK_SIZE / 4 ? size : ARENA_BLOCK_SIZE);
+    }
+
+    void* result = block->data + block->used;
+    block->used += size;
+    memset(result, 0, size);
+    return result;
+}
+
+static void arena_free(struct arena* a) {
+    struct arena_block* block = a->head;
+    while (block) {
+        struct arena_block* next = block->next;
+        free(block);
+        block = next;
+    }
+    free(a);
+}
+
+// Forget everything handed out, keeping the newest block for reuse.
+static void arena_reset(struct arena* a) {
+    if (!a->head) return;
+    struct arena_block* block = a->head->next;
+    while (block) {
+        struct arena_block* next = block->next;
+        a->bytes -= block->size;
+        free(block);
+        block = next;
+    }
+    a->head->next = null;
+    a->head->used = 0;
+}
+
+// Allocate from the arena if there is one, otherwise from the heap.
+static void* alloc(struct arena* a, size_t size) {
+    return a ? arena_alloc(a, size) : zmalloc(size);
+}
+
+// UTF-8 bytes.
 struct buffer {
     size_t capacity;
     size_t size;
-    cp* data;
-    cp  initial[BUFFER_INIT_MAX];
+    unsigned char* data;
+    unsigned char  initial[BUFFER_INIT_MAX];
 };
 
 struct buffer* buffer_init(struct buffer* b) {
@@ -42,13 +160,15 @@ struct buffer* buffer_init(struct buffer* b) {
     return b;
 }
 
-static void buffer_grow(struct buffer* b)
+// Buffers grown in an arena leave their old storage behind; it is released
+// with the arena.
+static void buffer_grow(struct arena* a, struct buffer* b)
 {
-    cp* data = b->data;
-    b->data = zmalloc(2 * b->capacity * sizeof(cp));
-    memcpy(b->data, data, b->capacity * sizeof(cp));
+    unsigned char* data = b->data;
+    b->data = alloc(a, 2 * b->capacity);
+    memcpy(b->data, data, b->capacity);
     b->capacity *= 2;
-    if (data != b->initial){
+    if (data != b->initial && !a){
         free(data);
     }
 }
@@ -64,39 +184,154 @@ static void buffer_move(struct buffer* dst, struct buffer* src) {
     buffer_init(src); // reset src, dst now owns the allocation.
 }
 
-static void buffer_free(struct buffer* b) {
-    if (b->data != b->initial){
+static void buffer_free(struct arena* a, struct buffer* b) {
+    if (b->data != b->initial && !a){
         free(b->data);
     }
 }
 
-static bool buffer_logging = false;
+static struct buffer* buffer_append(struct arena* a, struct buffer* b, const unsigned char* data, size_t size) {
+    while (b->capacity - b->size < size) {
+        buffer_grow(a, b);
+    }
+    memcpy(b->data + b->size, data, size);
+    b->size += size;
+    return b;
+}
 
-static struct buffer* buffer_push(struct buffer* b, cp c) {
-    if (b->size == b->capacity) {
-        buffer_grow(b);
+// Write the UTF-8 encoding of c to out, returning the number of bytes.
+// Surrogates and values past the last code point encode U+FFFD.
+static size_t utf8_encode(cp c, unsigned char out[4]) {
+    if (c < 0 || (c >= 0xD800 && c <= 0xDFFF) || c > 0x10FFFF) {
+        c = 0xFFFD;
     }
-    b->data[b->size++] = c;
-    if (buffer_logging){
-        printf("Pushing '%c' input buffer. [", c);
-        for (int i=0; i<b->size; i++){
-            printf("%c", b->data[i]);
-        }
-        printf("] size %ld\n", b->size);
+    if (c < 0x80) {
+        out[0] = c;
+        return 1;
     }
-    return b;
+    if (c < 0x800) {
+        out[0] = 0xC0 | (c >> 6);
+        out[1] = 0x80 | (c & 0x3F);
+        return 2;
+    }
+    if (c < 0x10000) {
+        out[0] = 0xE0 | (c >> 12);
+        out[1] = 0x80 | ((c >> 6) & 0x3F);
+        out[2] = 0x80 | (c & 0x3F);
+        return 3;
+    }
+    out[0] = 0xF0 | (c >> 18);
+    out[1] = 0x80 | ((c >> 12) & 0x3F);
+    out[2] = 0x80 | ((c >> 6) & 0x3F);
+    out[3] = 0x80 | (c & 0x3F);
+    return 4;
 }
 
-struct cursor {
-    unsigned line;
-    unsigned column;
+static struct buffer* buffer_push(struct arena* a, struct buffer* b, cp c) {
+    unsigned char bytes[4];
+    return buffer_append(a, b, bytes, utf8_encode(c, bytes));
+}
+
+// The value of a token. While every character appended is the next one from
+// the input, unchanged by preprocessing, the value is just a span of the input.
+// Escapes, substitutions and skipped characters copy the span into `buffer`
+// and the value is decoded from then on.
+struct text {
+    size_t offset;
+    size_t length;
+    bool decoded;
+    struct buffer buffer;
+};
+
+static struct text* text_init(struct text* t) {
+    t->offset  = 0;
+    t->length  = 0;
+    t->decoded = false;
+    buffer_init(&t->buffer);
+    return t;
+}
+
+static void text_move(struct text* dst, struct text* src) {
+    dst->offset  = src->offset;
+    dst->length  = src->length;
+    dst->decoded = src->decoded;
+    buffer_move(&dst->buffer, &src->buffer);
+    text_init(src);
+}
+
+static size_t text_size(struct text* t) {
+    return t->decoded ? t->buffer.size : t->length;
+}
+
+// The bytes of a value, given the input its spans point into.
+static const unsigned char* text_data(const unsigned char* source, struct text* t, size_t* size) {
+    *size = text_size(t);
+    return t->decoded ? t->buffer.data : source + t->offset;
+}
+
+// Atoms
+// Every distinct identifier, function name, at-keyword and unit a lexer meets
+// is interned as a small number, the same for each occurrence of the name up
+// to ASCII case, so later passes compare numbers instead of text. The first
+// atoms are the keywords of keywords.h: CSS properties, at-rules, units,
+// pseudo-classes and the functions and values later passes look for, with
+// flags saying which they are. That table is read-only and shared by every
+// lexer; other names are numbered by each lexer as it first sees them. Tokens
+// without a name have NO_ATOM.
+
+// Open addressing, with the hash kept next to the atom so most probes never
+// look at a name.
+struct atom_slot {
+    uint32_t hash;
+    unsigned atom; // NO_ATOM for a free slot
+};
+
+// Where the bytes of a name past the keywords are in `text`.
+struct atom_name {
+    size_t offset;
+    size_t length;
 };
 
+struct atoms {
+    struct atom_slot* slots;
+    size_t capacity; // a power of two, at most half full
+    size_t used;
+    struct atom_name* names;
+    size_t count;
+    size_t names_capacity;
+    struct buffer text;
+};
+
+enum input_kind {
+    INPUT_BORROWED, // caller owns the bytes
+    INPUT_OWNED,    // read from a FILE into a heap buffer
+    INPUT_MAPPED    // mapped from a file with mmap
+};
+
+// For lexers that are not given a context. Like every other file-scope object
+// it is never written, which is what lets parses run on many threads.
+static const struct crush_context default_context = {false, null, null};
+
+void crush_context_init(struct crush_context* context) {
+    *context = default_context;
+}
+
+// Ring buffer size for code points after `next`. Must be a power of two, and
+// large enough for a two character peek plus one reconsumed character.
+enum { LOOKAHEAD_MAX = 4 };
+
 struct lexer {
 
     // TODO: Double linked list of tokens in debug to ensure all memory is freed
     // correctly without leaks.
-    FILE* input;
+    const unsigned char* input;
+    size_t size;
+    size_t position; // The first byte that has not yet been read.
+    enum input_kind kind;
+
+    // Where tokens are allocated. Null outside of a parse, in which case
+    // tokens come from the heap and are released with token_free.
+    struct arena* arena;
 
     // The last character to have been consumed.
     cp current;
@@ -104,9 +339,33 @@ struct lexer {
     // The first character in the input stream that has not yet been consumed.
     cp next;
 
-    struct cursor cursor;
+    // Input offsets of the first byte of `current` and `next`.
+    size_t current_at;
+    size_t next_at;
+
+    // Input offset of the first byte of the token being consumed.
+    size_t token_at;
+
+    // Finds runs of characters that can be consumed in bulk.
+    const struct scanners* scan;
+
+    // Preprocessed code points following `next`, oldest first.
+    cp lookahead[LOOKAHEAD_MAX];
+    size_t lookahead_at[LOOKAHEAD_MAX];
+    unsigned lookahead_start;
+    unsigned lookahead_count;
+
     bool integer;
     bool id; // for hash
+    bool comments; // keep /*! */ comments as tokens
+    const struct crush_context* context;
+
+    // Whitespace is not returned as a token, only noted in space_before for
+    // the token after it.
+    bool fold_whitespace;
+    bool space_before; // whitespace came before the last token returned
+
+    struct atoms atoms;
 
     struct {
         bool consumtion;
@@ -165,15 +424,370 @@ enum {
     CHAR_MAX_CODE_POINT    = 0x10FFFF,
 };
 
+// 4.2. Definitions
+// Character classes, as bits of char_classes. The table is indexed by byte, so
+// the bytes of multi-byte UTF-8 sequences are name characters just as the code
+// points they encode are; classifying a code point only reads it below
+// CHAR_CONTROL. None of it depends on the C locale.
+enum {
+    CLASS_NAME_START    = 1 << 0,
+    CLASS_NAME          = 1 << 1,
+    CLASS_DIGIT         = 1 << 2,
+    CLASS_HEX           = 1 << 3,
+    CLASS_WHITESPACE    = 1 << 4, // after preprocessing: tab, newline, space
+    CLASS_NON_PRINTABLE = 1 << 5,
+    CLASS_STRUCTURAL    = 1 << 6, // ( ) , : ; [ ] { }, a token on their own
+    CLASS_UPPER         = 1 << 7, // ASCII upper case letter
+};
+
+static const unsigned char char_classes[256] = {
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x10, 0x10, 0x20, 0x00, 0x00, 0x20, 0x20, // 00
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, // 10
+    0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, 0x40, 0x00, 0x00, 0x40, 0x02, 0x00, 0x00, // 20
+    0x0e, 0x0e, 0x0e, 0x0e, 0x0e, 0x0e, 0x0e, 0x0e, 0x0e, 0x0e, 0x40, 0x40, 0x00, 0x00, 0x00, 0x00, // 30
+    0x00, 0x8b, 0x8b, 0x8b, 0x8b, 0x8b, 0x8b, 0x83, 0x83, 0x83, 0x83, 0x83, 0x83, 0x83, 0x83, 0x83, // 40
+    0x83, 0x83, 0x83, 0x83, 0x83, 0x83, 0x83, 0x83, 0x83, 0x83, 0x83, 0x40, 0x00, 0x40, 0x00, 0x03, // 50
+    0x00, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, // 60
+    0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x40, 0x00, 0x40, 0x00, 0x20, // 70
+    0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, // 80
+    0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, // 90
+    0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, // A0
+    0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, // B0
+    0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, // C0
+    0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, // D0
+    0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, // E0
+    0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, // F0
+};
+
+static bool char_is(cp c, unsigned char class) {
+    if ((unsigned)c < CHAR_CONTROL) {
+        return char_classes[c] & class;
+    }
+    // Every code point past ASCII is a name-start character; EOF is nothing.
+    return c >= CHAR_CONTROL && (class & (CLASS_NAME_START | CLASS_NAME));
+}
+
+static cp char_lower(cp c) {
+    return char_is(c, CLASS_UPPER) ? c + ('a' - 'A') : c;
+}
+
+// FNV-1a over the name folded to ASCII lower case.
+static uint32_t atom_hash(const unsigned char* data, size_t size) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ (unsigned char)char_lower(data[i])) * 16777619u;
+    }
+    return hash;
+}
+
+static const unsigned char* atom_text(struct atoms* a, unsigned atom, size_t* size) {
+    if (atom < ATOM_KEYWORD_COUNT) {
+        *size = keywords[atom].length;
+        return (const unsigned char*)keywords[atom].name;
+    }
+    struct atom_name* name = &a->names[atom - ATOM_KEYWORD_COUNT];
+    *size = name->length;
+    return a->text.data + name->offset;
+}
+
+static bool atom_matches(struct atoms* a, unsigned atom, const unsigned char* data, size_t size) {
+    size_t length;
+    const unsigned char* text = atom_text(a, atom, &length);
+    if (length != size) return false;
+    for (size_t i = 0; i < size; i++) {
+        if (char_lower(text[i]) != char_lower(data[i])) return false;
+    }
+    return true;
+}
+
+// The keyword a name is, if any. The perfect hash gives the only keyword it
+// could be, and one comparison tells.
+static unsigned keyword_atom(uint32_t hash, const unsigned char* data, size_t size) {
+    uint32_t d = keyword_displacements[hash & (KEYWORD_BUCKETS - 1)];
+    unsigned atom = keyword_slots[((hash ^ d) * 0x9E3779B1u) >> (32 - KEYWORD_SLOT_BITS)];
+    return atom != NO_ATOM && atom_matches(null, atom, data, size) ? atom : NO_ATOM;
+}
+
+static void atoms_grow(struct atoms* a) {
+    struct atom_slot* slots = a->slots;
+    size_t capacity = a->capacity;
+
+    a->capacity = capacity ? capacity * 2 : 256;
+    a->slots = zmalloc(a->capacity * sizeof(struct atom_slot));
+    for (size_t i = 0; i < capacity; i++) {
+        if (slots[i].atom == NO_ATOM) continue;
+        size_t j = slots[i].hash & (a->capacity - 1);
+        while (a->slots[j].atom != NO_ATOM) j = (j + 1) & (a->capacity - 1);
+        a->slots[j] = slots[i];
+    }
+    free(slots);
+}
+
+// A name's atom, given a new one if this is its first occurrence.
+static unsigned atoms_intern(struct atoms* a, const unsigned char* data, size_t size) {
+    uint32_t hash = atom_hash(data, size);
+    unsigned atom = keyword_atom(hash, data, size);
+    if (atom != NO_ATOM) return atom;
+
+    if (2 * (a->used + 1) > a->capacity) atoms_grow(a);
+    size_t i = hash & (a->capacity - 1);
+    for (; a->slots[i].atom != NO_ATOM; i = (i + 1) & (a->capacity - 1)) {
+        if (a->slots[i].hash == hash && atom_matches(a, a->slots[i].atom, data, size)) {
+            return a->slots[i].atom;
+        }
+    }
+
+    if (a->count == a->names_capacity) {
+        a->names_capacity = a->names_capacity ? a->names_capacity * 2 : 256;
+        a->names = zrealloc(a->names, a->names_capacity * sizeof(struct atom_name));
+    }
+    a->names[a->count].offset = a->text.size;
+    a->names[a->count].length = size;
+    buffer_append(null, &a->text, data, size);
+    atom = ATOM_KEYWORD_COUNT + a->count++;
+
+    a->slots[i].hash = hash;
+    a->slots[i].atom = atom;
+    a->used++;
+    return atom;
+}
+
+static void atoms_free(struct atoms* a) {
+    free(a->slots);
+    free(a->names);
+    buffer_free(null, &a->text);
+}
+
+// The atom in `to` of each name past the keywords in `from`, in the order
+// `from` numbered them, interning the ones `to` has not seen. Null if every
+// name has the same atom in both.
+static unsigned* atoms_merge(struct atoms* to, struct atoms* from) {
+    if (from->count == 0) return null;
+
+    unsigned* map = zmalloc(from->count * sizeof(unsigned));
+    bool same = true;
+    for (size_t i = 0; i < from->count; i++) {
+        size_t size;
+        const unsigned char* name = atom_text(from, ATOM_KEYWORD_COUNT + i, &size);
+        map[i] = atoms_intern(to, name, size);
+        same = same && map[i] == ATOM_KEYWORD_COUNT + i;
+    }
+    if (same) {
+        free(map);
+        return null;
+    }
+    return map;
+}
+
+static bool atom_is(unsigned atom, enum keyword_flags flag) {
+    return atom < ATOM_KEYWORD_COUNT && (keywords[atom].flags & flag);
+}
+
+// Runs
+// Most of a stylesheet is runs of name characters, whitespace and string
+// contents. A scanner returns how many of the `n` bytes at `s` continue such a
+// run. Runs only hold ASCII bytes that preprocessing leaves alone, so each
+// byte is one character; anything else ends the run and is left to the code
+// point at a time path. The vector versions look at 16 or 32 bytes a step.
+struct scanners {
+    size_t (*name)(const unsigned char* s, size_t n);
+    size_t (*whitespace)(const unsigned char* s, size_t n);
+    size_t (*string)(const unsigned char* s, size_t n, unsigned char quote);
+};
+
+static size_t scan_class(const unsigned char* s, size_t n, unsigned char class) {
+    size_t i = 0;
+    while (i < n && s[i] < CHAR_CONTROL && (char_classes[s[i]] & class)) i++;
+    return i;
+}
+
+static size_t scan_name_scalar(const unsigned char* s, size_t n) {
+    return scan_class(s, n, CLASS_NAME);
+}
+
+static size_t scan_whitespace_scalar(const unsigned char* s, size_t n) {
+    return scan_class(s, n, CLASS_WHITESPACE);
+}
+
+// Everything but the quote, escapes, newlines before preprocessing and NULL.
+static size_t scan_string_scalar(const unsigned char* s, size_t n, unsigned char quote) {
+    size_t i = 0;
+    for (; i < n; i++) {
+        unsigned char c = s[i];
+        if (c >= CHAR_CONTROL || c == quote || c == CHAR_REVERSE_SOLIDUS ||
+            c == CHAR_LINE_FEED || c == CHAR_CARRIAGE_RETURN || c == CHAR_FORM_FEED ||
+            c == CHAR_NULL) {
+            break;
+        }
+    }
+    return i;
+}
+
+static const struct scanners scanners_scalar = {
+    scan_name_scalar, scan_whitespace_scalar, scan_string_scalar
+};
+
+#ifdef CRUSH_X86
+
+// Bytes from 0x80 up are negative as signed bytes, so the range compares
+// below never take them for ASCII.
+
+__attribute__((target("sse2")))
+static size_t scan_name_sse2(const unsigned char* s, size_t n) {
+    const __m128i case_bit = _mm_set1_epi8(0x20);
+    const __m128i before_a = _mm_set1_epi8('a' - 1), after_z = _mm_set1_epi8('z' + 1);
+    const __m128i before_0 = _mm_set1_epi8('0' - 1), after_9 = _mm_set1_epi8('9' + 1);
+    const __m128i hyphen = _mm_set1_epi8('-'), low_line = _mm_set1_epi8('_');
+
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(s + i));
+        __m128i folded = _mm_or_si128(v, case_bit);
+        __m128i letter = _mm_and_si128(_mm_cmpgt_epi8(folded, before_a), _mm_cmpgt_epi8(after_z, folded));
+        __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(v, before_0), _mm_cmpgt_epi8(after_9, v));
+        __m128i other = _mm_or_si128(_mm_cmpeq_epi8(v, hyphen), _mm_cmpeq_epi8(v, low_line));
+        unsigned mask = _mm_movemask_epi8(_mm_or_si128(_mm_or_si128(letter, digit), other));
+        if (mask != 0xFFFF) return i + __builtin_ctz(~mask);
+    }
+    return i + scan_name_scalar(s + i, n - i);
+}
+
+__attribute__((target("sse2")))
+static size_t scan_whitespace_sse2(const unsigned char* s, size_t n) {
+    const __m128i space = _mm_set1_epi8(' '), tab = _mm_set1_epi8('\t'), newline = _mm_set1_epi8('\n');
+
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(s + i));
+        __m128i match = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, space), _mm_cmpeq_epi8(v, tab)),
+                                     _mm_cmpeq_epi8(v, newline));
+        unsigned mask = _mm_movemask_epi8(match);
+        if (mask != 0xFFFF) return i + __builtin_ctz(~mask);
+    }
+    return i + scan_whitespace_scalar(s + i, n - i);
+}
+
+__attribute__((target("sse2")))
+static size_t scan_string_sse2(const unsigned char* s, size_t n, unsigned char quote) {
+    const __m128i q = _mm_set1_epi8(quote), solidus = _mm_set1_epi8('\\');
+    const __m128i newline = _mm_set1_epi8('\n'), cr = _mm_set1_epi8('\r'), ff = _mm_set1_epi8('\f');
+    const __m128i zero = _mm_setzero_si128();
+
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(s + i));
+        __m128i stop = _mm_or_si128(_mm_cmpeq_epi8(v, q), _mm_cmpeq_epi8(v, solidus));
+        stop = _mm_or_si128(stop, _mm_or_si128(_mm_cmpeq_epi8(v, newline), _mm_cmpeq_epi8(v, cr)));
+        stop = _mm_or_si128(stop, _mm_or_si128(_mm_cmpeq_epi8(v, ff), _mm_cmpeq_epi8(v, zero)));
+        stop = _mm_or_si128(stop, _mm_cmpgt_epi8(zero, v));
+        unsigned mask = _mm_movemask_epi8(stop);
+        if (mask != 0) return i + __builtin_ctz(mask);
+    }
+    return i + scan_string_scalar(s + i, n - i, quote);
+}
+
+__attribute__((target("avx2")))
+static size_t scan_name_avx2(const unsigned char* s, size_t n) {
+    const __m256i case_bit = _mm256_set1_epi8(0x20);
+    const __m256i before_a = _mm256_set1_epi8('a' - 1), after_z = _mm256_set1_epi8('z' + 1);
+    const __m256i before_0 = _mm256_set1_epi8('0' - 1), after_9 = _mm256_set1_epi8('9' + 1);
+    const __m256i hyphen = _mm256_set1_epi8('-'), low_line = _mm256_set1_epi8('_');
+
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(s + i));
+        __m256i folded = _mm256_or_si256(v, case_bit);
+        __m256i letter = _mm256_and_si256(_mm256_cmpgt_epi8(folded, before_a),
+                                          _mm256_cmpgt_epi8(after_z, folded));
+        __m256i digit = _mm256_and_si256(_mm256_cmpgt_epi8(v, before_0), _mm256_cmpgt_epi8(after_9, v));
+        __m256i other = _mm256_or_si256(_mm256_cmpeq_epi8(v, hyphen), _mm256_cmpeq_epi8(v, low_line));
+        unsigned mask = _mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(letter, digit), other));
+        if (mask != 0xFFFFFFFF) return i + __builtin_ctz(~mask);
+    }
+    return i + scan_name_sse2(s + i, n - i);
+}
+
+__attribute__((target("avx2")))
+static size_t scan_whitespace_avx2(const unsigned char* s, size_t n) {
+    const __m256i space = _mm256_set1_epi8(' '), tab = _mm256_set1_epi8('\t');
+    const __m256i newline = _mm256_set1_epi8('\n');
+
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(s + i));
+        __m256i match = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, space),
+                                                        _mm256_cmpeq_epi8(v, tab)),
+                                        _mm256_cmpeq_epi8(v, newline));
+        unsigned mask = _mm256_movemask_epi8(match);
+        if (mask != 0xFFFFFFFF) return i + __builtin_ctz(~mask);
+    }
+    return i + scan_whitespace_sse2(s + i, n - i);
+}
+
+__attribute__((target("avx2")))
+static size_t scan_string_avx2(const unsigned char* s, size_t n, unsigned char quote) {
+    const __m256i q = _mm256_set1_epi8(quote), solidus = _mm256_set1_epi8('\\');
+    const __m256i newline = _mm256_set1_epi8('\n'), cr = _mm256_set1_epi8('\r');
+    const __m256i ff = _mm256_set1_epi8('\f'), zero = _mm256_setzero_si256();
+
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(s + i));
+        __m256i stop = _mm256_or_si256(_mm256_cmpeq_epi8(v, q), _mm256_cmpeq_epi8(v, solidus));
+        stop = _mm256_or_si256(stop, _mm256_or_si256(_mm256_cmpeq_epi8(v, newline),
+                                                     _mm256_cmpeq_epi8(v, cr)));
+        stop = _mm256_or_si256(stop, _mm256_or_si256(_mm256_cmpeq_epi8(v, ff),
+                                                     _mm256_cmpeq_epi8(v, zero)));
+        stop = _mm256_or_si256(stop, _mm256_cmpgt_epi8(zero, v));
+        unsigned mask = _mm256_movemask_epi8(stop);
+        if (mask != 0) return i + __builtin_ctz(mask);
+    }
+    return i + scan_string_sse2(s + i, n - i, quote);
+}
+
+static const struct scanners scanners_sse2 = {
+    scan_name_sse2, scan_whitespace_sse2, scan_string_sse2
+};
+
+static const struct scanners scanners_avx2 = {
+    scan_name_avx2, scan_whitespace_avx2, scan_string_avx2
+};
+
+#endif
+
+// The widest scanners the CPU runs. CRUSH_SCAN=scalar, sse2 or avx2 in the
+// environment asks for a narrower set, to compare them.
+static const struct scanners* scanners_select(void) {
+    const char* wanted = getenv("CRUSH_SCAN");
+    if (wanted && strcmp(wanted, "scalar") == 0) return &scanners_scalar;
+
+#ifdef CRUSH_X86
+    // The CPU is looked at before main runs, so this only reads what was found
+    // and is safe from any thread.
+    bool sse2 = __builtin_cpu_supports("sse2");
+    bool avx2 = __builtin_cpu_supports("avx2");
+    if (wanted && strcmp(wanted, "sse2") == 0) avx2 = false;
+    if (avx2) return &scanners_avx2;
+    if (sse2) return &scanners_sse2;
+#endif
+    return &scanners_scalar;
+}
+
 struct token {
     enum token_type type;
+    bool pooled; // allocated in an arena, and freed with it
+    unsigned atom; // the name of idents, functions and at-keywords; the unit of dimensions
 
     union {
 
         struct  {
             bool integer; // type is integer or number
-            double value; // Numeric value
-            struct buffer unit;
+            bool converted; // Whether `as` holds the value yet
+            union {
+                const unsigned char* digits; // Until converted, the text
+                double value;                // Numeric value
+            } as;
+            struct text unit;
         } number;
 
         struct {
@@ -191,8 +805,7 @@ struct token {
 
     } value;
 
-    struct buffer buffer;
-    struct cursor cursor;
+    struct text text;
 
     // TODO: move this to parser
     // This is the next token in a list of
@@ -202,9 +815,11 @@ struct token {
 
 void token_free(struct token* t) {
 
-    buffer_free(&t->buffer);
+    if (t->pooled) return;
+
+    buffer_free(null, &t->text.buffer);
     if (t->type == TOKEN_DIMENSION){
-        buffer_free(&t->value.number.unit);
+        buffer_free(null, &t->value.number.unit.buffer);
     }
     free(t);
 }
@@ -213,95 +828,256 @@ enum token_type token_type(struct token* t) {
     return t->type;
 }
 
-static void buffer_print_(FILE* file, struct buffer* b){
-    for (int i = 0; i< b->size; i++){
-        fprintf(file, "%c", p(b->data[i]));
-    }
+static bool is_exp(cp c) {
+    return c == CHAR_LATIN_CAPITAL_E || c == CHAR_LATIN_SMALL_E;
 }
 
-// todo: delete this function
-static void buffer_print(FILE* file, struct token* t){
-    buffer_print_(file, &t->buffer);
+static bool is_sign(cp c) {
+    return c == CHAR_PLUS_SIGN || c == CHAR_HYPHEN_MINUS;
 }
 
-static double num_sign(struct buffer* b, int* current){
-    cp first = b->data[*current];
+// 4.3.13. Convert a string to a number
+//
+// The lexer only accepts [+-]digits[.digits][(e|E)[+-]digits], and the result
+// is the double nearest to it, ties to even, as strtod would give.
+//
+// The first 19 significant digits are read into a 64 bit integer w and the
+// rest become a power of ten, so the number is w * 10^q. Small enough w and q
+// are exact as doubles and need one multiplication or division. Otherwise
+// w * 5^q is multiplied out to 128 bits with a table of powers of five, which
+// the Eisel-Lemire algorithm shows is enough to round correctly; the 2^q
+// goes straight into the exponent. Digits past the 19th can still change the
+// rounding, so then w and w + 1 are both tried, and strtod settles the rare
+// case where they disagree.
+
+// The high and low halves of a * b.
+static uint64_t multiply_128(uint64_t a, uint64_t b, uint64_t* low) {
+#ifdef __SIZEOF_INT128__
+    unsigned __int128 product = (unsigned __int128)a * b;
+    *low = (uint64_t)product;
+    return (uint64_t)(product >> 64);
+#else
+    uint64_t a_low = (uint32_t)a, a_high = a >> 32;
+    uint64_t b_low = (uint32_t)b, b_high = b >> 32;
+    uint64_t low_low = a_low * b_low, high_low = a_high * b_low;
+    uint64_t low_high = a_low * b_high, high_high = a_high * b_high;
+    uint64_t middle = high_low + (low_low >> 32) + (uint32_t)low_high;
+    *low = middle << 32 | (uint32_t)low_low;
+    return high_high + (middle >> 32) + (low_high >> 32);
+#endif
+}
 
-    if (first == CHAR_HYPHEN_MINUS) {
-        (*current)++;
-        return -1;
+static int leading_zeros(uint64_t x) {
+    int n = 0;
+    while (!(x & (UINT64_C(1) << 63))) {
+        x <<= 1;
+        n++;
     }
+    return n;
+}
 
-    if (first == CHAR_PLUS_SIGN) {
-        (*current)++;
-    }
+enum {
+    DOUBLE_MANTISSA_BITS = 52,
+    DOUBLE_INFINITE_POWER = 0x7FF
+};
 
-    return 1;
-}
+// The bits of w * 10^q as a positive double, w not zero.
+static uint64_t eisel_lemire(uint64_t w, int64_t q) {
+    if (q < POW5_MIN) return 0;
+    if (q > POW5_MAX) return (uint64_t)DOUBLE_INFINITE_POWER << DOUBLE_MANTISSA_BITS;
+
+    int zeros = leading_zeros(w);
+    w <<= zeros;
+
+    // The top 64 bits of w * 5^q, and the next 64 when they are needed to
+    // tell which way to round.
+    const uint64_t* power = pow5[q - POW5_MIN];
+    uint64_t low, high = multiply_128(w, power[0], &low);
+    const uint64_t precision = UINT64_MAX >> (DOUBLE_MANTISSA_BITS + 3);
+    if ((high & precision) == precision) {
+        uint64_t second_low, second_high = multiply_128(w, power[1], &second_low);
+        low += second_high;
+        if (second_high > low) high++;
+    }
 
-static int num_integer(struct buffer* b, int* current, int* num_digits) {
-    assert((num_digits == 0) || ((*num_digits) == 0));
+    int upper = (int)(high >> 63);
+    int shift = upper + 64 - DOUBLE_MANTISSA_BITS - 3;
+    uint64_t mantissa = high >> shift;
+    // floor(log2(10^q)) + 63, and the exponent bias
+    int64_t exponent = (((152170 + 65536) * q) >> 16) + 63 + upper - zeros + 1023;
+
+    if (exponent <= 0) {
+        // Subnormal, or too small even for that.
+        if (-exponent + 1 >= 64) return 0;
+        mantissa >>= -exponent + 1;
+        mantissa += mantissa & 1;
+        mantissa >>= 1;
+        exponent = mantissa < (UINT64_C(1) << DOUBLE_MANTISSA_BITS) ? 0 : 1;
+        return (uint64_t)exponent << DOUBLE_MANTISSA_BITS | (mantissa & ((UINT64_C(1) << DOUBLE_MANTISSA_BITS) - 1));
+    }
 
-    int i = 0;
-    for (cp c = b->data[*current]; isdigit(c); c = b->data[++(*current)]) {
-        i = i * 10;
-        i = i + (c - '0');
+    // Round half up, except that a product exactly halfway rounds to even.
+    // Only these powers of ten can be exactly halfway.
+    if (low <= 1 && q >= -4 && q <= 23 && (mantissa & 3) == 1 &&
+        (mantissa << shift) == high) {
+        mantissa &= ~UINT64_C(1);
+    }
+    mantissa += mantissa & 1;
+    mantissa >>= 1;
+    if (mantissa >= (UINT64_C(2) << DOUBLE_MANTISSA_BITS)) {
+        mantissa = UINT64_C(1) << DOUBLE_MANTISSA_BITS;
+        exponent++;
+    }
+    mantissa &= ~(UINT64_C(1) << DOUBLE_MANTISSA_BITS);
 
-        if (num_digits) (*num_digits)++;
+    if (exponent >= DOUBLE_INFINITE_POWER) {
+        return (uint64_t)DOUBLE_INFINITE_POWER << DOUBLE_MANTISSA_BITS;
     }
-    return i;
+    return (uint64_t)exponent << DOUBLE_MANTISSA_BITS | mantissa;
 }
 
-static bool is_exp(cp c) {
-    return c == CHAR_LATIN_CAPITAL_E || c == CHAR_LATIN_SMALL_E;
-}
+// The number without the help of the table.
+static double string_to_number_slow(const unsigned char* data, size_t size) {
+    char small[64];
+    char* copy = size < sizeof(small) ? small : zmalloc(size + 1);
 
-static bool is_sign(cp c) {
-    return c == CHAR_PLUS_SIGN || c == CHAR_HYPHEN_MINUS;
-}
+    memcpy(copy, data, size);
+    copy[size] = '\0';
+    double result = strtod(copy, null);
 
-static double compute_value(double s, double i, double f, double d, double t, double e) {
-    return s * (i + f *  powf(10, -d)) * powf(10, t*e);
+    if (copy != small) free(copy);
+    return result;
 }
 
-static double string_to_number(struct buffer* b) {
-    int current = 0;
-    int d = 0;
+static double string_to_number(const unsigned char* data, size_t size) {
+    const unsigned char* s = data;
+    const unsigned char* end = data + size;
+
+    bool negative = s < end && *s == CHAR_HYPHEN_MINUS;
+    if (s < end && is_sign(*s)) s++;
+
+    uint64_t w = 0;
+    int64_t q = 0;
+    int significant = 0;
+    bool truncated = false;
+    bool fraction = false;
+
+    for (; s < end; s++) {
+        if (*s == CHAR_FULL_STOP) {
+            fraction = true;
+            continue;
+        }
+        if (!char_is(*s, CLASS_DIGIT)) break;
+
+        unsigned digit = *s - '0';
+        if (significant < 19) {
+            w = w * 10 + digit;
+            significant += w != 0;
+            q -= fraction;
+        } else {
+            truncated |= digit != 0;
+            q += !fraction;
+        }
+    }
+
+    if (s < end) {
+        s++; // the e
+        bool negative_exponent = *s == CHAR_HYPHEN_MINUS;
+        if (is_sign(*s)) s++;
 
-    double s = num_sign(b, &current);
-    int i = num_integer(b, &current, 0);
+        // Past this any number is zero or infinite.
+        const int64_t limit = 100000;
+        int64_t exponent = 0;
+        for (; s < end; s++) {
+            if (exponent < limit) exponent = exponent * 10 + (*s - '0');
+        }
+        q += negative_exponent ? -exponent : exponent;
+    }
 
-    if (b->data[current] == '.') {
-        (current)++;
+    double result;
+    if (w == 0) {
+        result = 0;
+    } else if (FLT_EVAL_METHOD == 0 && !truncated && w <= UINT64_C(1) << 53 && q >= -22 && q <= 22) {
+        // Both w and 10^|q| are exact doubles, so one rounding gives the
+        // nearest double to their product or quotient.
+        static const double exact[23] = {
+            1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+            1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+        };
+        result = q < 0 ? (double)w / exact[-q] : (double)w * exact[q];
+    } else {
+        uint64_t bits = eisel_lemire(w, q);
+        if (truncated && eisel_lemire(w + 1, q) != bits) {
+            return string_to_number_slow(data, size);
+        }
+        memcpy(&result, &bits, sizeof(result));
     }
+    return negative ? -result : result;
+}
 
-    int f = num_integer(b, &current, &d);
+// Numbers are converted the first time their value is asked for: written out
+// unchanged, most never are.
+static double number_value(struct token* t) {
+    assert(t->type == TOKEN_NUMBER || t->type == TOKEN_PERCENTAGE || t->type == TOKEN_DIMENSION);
+    if (!t->value.number.converted) {
+        t->value.number.as.value = string_to_number(t->value.number.as.digits, t->text.length);
+        t->value.number.converted = true;
+    }
+    return t->value.number.as.value;
+}
 
-    int t = 1;
-    double e = 0;
+// Length of the UTF-8 sequence a lead byte starts, or 0 if it cannot start one.
+static unsigned utf8_length(unsigned char lead) {
+    if (lead < 0x80) return 1;
+    if (lead < 0xC2) return 0; // continuation or overlong two byte lead
+    if (lead < 0xE0) return 2;
+    if (lead < 0xF0) return 3;
+    if (lead < 0xF5) return 4;
+    return 0;
+}
 
-    if (is_exp(b->data[current])) {
-        current++;
+// Decode the UTF-8 sequence at s, of which `available` bytes may be read,
+// storing its length. Malformed sequences decode as U+FFFD of length one.
+static cp utf8_decode(const unsigned char* s, size_t available, size_t* length) {
+    unsigned n = utf8_length(s[0]);
 
-        t = num_sign(b, &current);
-        e = num_integer(b, &current, 0);
+    *length = 1;
+    if (n == 1) {
+        return s[0];
     }
 
-    double result = compute_value(s, i, f, d, t, e);
+    if (n == 0 || available < n) {
+        return CHAR_REPLACEMENT;
+    }
 
-    //printf("Parsing buffer: ");
-    //buffer_print_(stdout, b);
-    //printf(" to number %g\n", result);
+    cp c = s[0] & (0x7F >> n);
+    for (unsigned i = 1; i < n; i++) {
+        if ((s[i] & 0xC0) != 0x80) {
+            return CHAR_REPLACEMENT;
+        }
+        c = (c << 6) | (s[i] & 0x3F);
+    }
 
-    return result;
+    // Reject overlong forms and surrogates.
+    static const cp minimum[5] = {0, 0, 0x80, 0x800, 0x10000};
+    if (c < minimum[n] || c > CHAR_MAX_CODE_POINT || (c >= 0xD800 && c <= 0xDFFF)) {
+        return CHAR_REPLACEMENT;
+    }
 
+    *length = n;
+    return c;
 }
 
-static void ungetcf(int c, FILE* stream){
-    if (ungetc(c, stream) != c){
-        fprintf(stderr, "Error putting 0x%X back into input stream.\n", c);
-        exit(EXIT_FAILURE);
+// Decode the code point at the read position.
+static cp input_read(struct lexer* L) {
+    if (L->position == L->size) {
+        return CHAR_EOF;
     }
+
+    size_t length;
+    cp c = utf8_decode(L->input + L->position, L->size - L->position, &length);
+    L->position += length;
+    return c;
 }
 
 /*
@@ -318,31 +1094,63 @@ static void ungetcf(int c, FILE* stream){
  FEED (LF) by a single U+000A LINE FEED (LF) character.
  - Replace any U+0000 NULL characters with U+FFFD REPLACEMENT CHARACTER.
  */
-static cp lexer_preprocess(FILE* input) {
-    cp next = fgetc(input);
+static cp lexer_preprocess(struct lexer* L, size_t* at) {
+    *at = L->position;
+    cp next = input_read(L);
 
-    if (next == CHAR_NULL) {
-        return CHAR_REPLACEMENT;
+    switch (next) {
+        case CHAR_NULL:
+            return CHAR_REPLACEMENT;
+
+        case CHAR_CARRIAGE_RETURN:
+            if (L->position < L->size && L->input[L->position] == CHAR_LINE_FEED) {
+                L->position++;
+            }
+            return CHAR_LINE_FEED;
+
+        case CHAR_FORM_FEED:
+            return CHAR_LINE_FEED;
+
+        default:
+            return next;
     }
+}
 
-    if (next == CHAR_CARRIAGE_RETURN) {
-        next = fgetc(input);
-        if (next != CHAR_LINE_FEED) {
-            ungetcf(next, input);
-        }
-        return CHAR_LINE_FEED;
+// The code point `offset` places after L->next, without consuming anything.
+static cp lexer_peek(struct lexer* L, unsigned offset) {
+    assert(offset < LOOKAHEAD_MAX);
+    while (L->lookahead_count <= offset) {
+        unsigned end = (L->lookahead_start + L->lookahead_count) & (LOOKAHEAD_MAX - 1);
+        L->lookahead[end] = lexer_preprocess(L, &L->lookahead_at[end]);
+        L->lookahead_count++;
     }
+    return L->lookahead[(L->lookahead_start + offset) & (LOOKAHEAD_MAX - 1)];
+}
 
-    return next;
+// Take the code point after L->next, from the lookahead if it has one.
+static cp lexer_pull(struct lexer* L, size_t* at) {
+    if (L->lookahead_count == 0) {
+        return lexer_preprocess(L, at);
+    }
+    cp c = L->lookahead[L->lookahead_start];
+    *at = L->lookahead_at[L->lookahead_start];
+    L->lookahead_start = (L->lookahead_start + 1) & (LOOKAHEAD_MAX - 1);
+    L->lookahead_count--;
+    return c;
 }
 
 static void lexer_recomsume(struct lexer* L)
 {
     if (L->logging.consumtion) {
-        printf("Line %d:%d: unconsuming %c (0x%02X)\n", L->cursor.line, L->cursor.column, p(L->current), L->current);
+        printf("At %zu: unconsuming %c (0x%02X)\n", L->current_at, p(L->current), L->current);
     }
-    ungetcf(L->next, L->input);
+    assert(L->lookahead_count < LOOKAHEAD_MAX);
+    L->lookahead_start = (L->lookahead_start - 1) & (LOOKAHEAD_MAX - 1);
+    L->lookahead[L->lookahead_start] = L->next;
+    L->lookahead_at[L->lookahead_start] = L->next_at;
+    L->lookahead_count++;
     L->next = L->current;
+    L->next_at = L->current_at;
     L->current = CHAR_NULL;
 }
 
@@ -351,20 +1159,118 @@ static void lexer_consume(struct lexer* L)
 {
     // consume
     L->current = L->next;
-    L->next = lexer_preprocess(L->input);
+    L->current_at = L->next_at;
+    L->next = lexer_pull(L, &L->next_at);
+
+    if (L->logging.consumtion) {
+        printf("At %zu: Consuming %c (0x%02X); next is %c (0x%02X)\n",
+               L->current_at, p(L->current), L->current, p(L->next), L->next);
+    }
+}
+
+// Skip the comment that L->current and L->next open, leaving its closing
+// solidus as the current character, or the end of the input if it is never
+// closed. Returns the offset just past the comment.
+//
+// The end is found with memchr over the raw input rather than character by
+// character: neither `*` nor `/` can be part of a longer UTF-8 sequence, and
+// preprocessing leaves both alone.
+static size_t lexer_skip_comment(struct lexer* L) {
+    assert(L->current == CHAR_SOLIDUS && L->next == CHAR_ASTERISK);
+    const unsigned char* s = L->input;
+    size_t end = L->size;
+    bool closed = false;
+
+    size_t from = L->next_at + 1;
+    while (from < L->size) {
+        const unsigned char* star = memchr(s + from, CHAR_ASTERISK, L->size - from);
+        if (!star) break;
+        from = star - s + 1;
+        if (from < L->size && s[from] == CHAR_SOLIDUS) {
+            end = from + 1;
+            closed = true;
+            break;
+        }
+    }
 
     if (L->logging.consumtion) {
-        printf("Line %d:%d: Consuming %c (0x%02X); next is %c (0x%02X)\n",
-               L->cursor.line, L->cursor.column, p(L->current), L->current, p(L->next), L->next);
+        printf("comment skipping: %.*s\n", (int)(end - L->current_at), s + L->current_at);
+    }
+
+    L->current = closed ? CHAR_SOLIDUS : CHAR_EOF;
+    L->current_at = closed ? end - 1 : end;
+    L->lookahead_count = 0;
+    L->position = end;
+    L->next = lexer_preprocess(L, &L->next_at);
+    return end;
+}
+
+// Switch a text over to its own buffer, copying out what the span covered.
+static void text_decode(struct lexer* L, struct text* t) {
+    if (t->decoded) return;
+    buffer_append(L->arena, &t->buffer, L->input + t->offset, t->length);
+    t->decoded = true;
+}
+
+// Append a character that does not appear as-is in the input, like the
+// result of an escape.
+static void text_push(struct lexer* L, struct text* t, cp c) {
+    text_decode(L, t);
+    buffer_push(L->arena, &t->buffer, c);
+}
+
+// Whether the current character's bytes in the input are exactly its UTF-8
+// encoding, i.e. neither preprocessing nor decoding replaced it.
+static bool lexer_current_verbatim(struct lexer* L) {
+    if (L->current == CHAR_EOF) return false;
+    if (L->current < CHAR_CONTROL) return L->input[L->current_at] == L->current;
+    return L->current != CHAR_REPLACEMENT || L->next_at - L->current_at == 3;
+}
+
+// Append the current input character.
+static void text_append(struct lexer* L, struct text* t) {
+    if (!t->decoded) {
+        bool verbatim = lexer_current_verbatim(L);
+        if (t->length == 0) {
+            t->offset = L->current_at;
+        }
+        if (verbatim && t->offset + t->length == L->current_at) {
+            t->length += L->next_at - L->current_at;
+            return;
+        }
     }
+    text_push(L, t, L->current);
+}
 
-    L->cursor.column++;
-    if (L->current == CHAR_LINE_FEED){
-        L->cursor.line++;
-        L->cursor.column = 1;
+// Consume the `n` characters of a run that starts at L->next, appending them
+// to `t` unless it is null. The run must come from one of L->scan's scanners.
+static void lexer_consume_run(struct lexer* L, struct text* t, size_t n) {
+    size_t start = L->next_at;
+    L->current = L->input[start + n - 1];
+    L->current_at = start + n - 1;
+    L->position = start + n;
+    L->next = lexer_preprocess(L, &L->next_at);
+
+    if (!t) return;
+    if (!t->decoded) {
+        if (t->length == 0) {
+            t->offset = start;
+        }
+        if (t->offset + t->length == start) {
+            t->length += n;
+            return;
+        }
+        text_decode(L, t);
     }
+    buffer_append(L->arena, &t->buffer, L->input + start, n);
 }
 
+// How many characters of a run start at L->next, as found by the `kind` scanner. Runs are
+// skipped while peeked characters are waiting or consumption is being logged.
+#define lexer_run(L, kind, ...) \
+    ((L)->lookahead_count || (L)->logging.consumtion ? 0 : \
+     (L)->scan->kind((L)->input + (L)->next_at, (L)->size - (L)->next_at, ##__VA_ARGS__))
+
 const char* token_name(int t){
     switch (t){
 #define NAME(X) case (X): return #X;
@@ -391,6 +1297,7 @@ const char* token_name(int t){
             NAME(TOKEN_WHITESPACE);
             NAME(TOKEN_CDO);
             NAME(TOKEN_CDC);
+            NAME(TOKEN_COMMENT);
             NAME(TOKEN_COLON);
             NAME(TOKEN_SEMICOLON);
             NAME(TOKEN_COMMA);
@@ -406,12 +1313,50 @@ const char* token_name(int t){
 }
 
 static struct token* token_simple(struct lexer* L, int type) {
-    struct token* t = zmalloc(sizeof(struct token));
+    struct token* t = alloc(L->arena, sizeof(struct token));
+    t->pooled = L->arena != null;
     t->type   = type;
-    t->cursor = L->cursor;
     return t;
 }
 
+// Tokens that are nothing but their type, like punctuation and whitespace,
+// are most of a stylesheet. There is one shared, never freed instance of each
+// rather than one allocation per token; where a token was is kept by whoever
+// reads them, like the parser.
+#define SHARED(T) [T] = {T, true}
+static const struct token shared_tokens[] = {
+    SHARED(TOKEN_EOF),
+    SHARED(TOKEN_INCLUDE_MATCH),
+    SHARED(TOKEN_DASH_MATCH),
+    SHARED(TOKEN_PREFIX_MATCH),
+    SHARED(TOKEN_SUFFIX_MATCH),
+    SHARED(TOKEN_SUBSTRING_MATCH),
+    SHARED(TOKEN_COLUMN),
+    SHARED(TOKEN_WHITESPACE),
+    SHARED(TOKEN_CDO),
+    SHARED(TOKEN_CDC),
+    SHARED(TOKEN_COLON),
+    SHARED(TOKEN_SEMICOLON),
+    SHARED(TOKEN_COMMA),
+    SHARED(TOKEN_LEFT_SQUARE),
+    SHARED(TOKEN_RIGHT_SQUARE),
+    SHARED(TOKEN_PAREN_LEFT),
+    SHARED(TOKEN_PAREN_RIGHT),
+    SHARED(TOKEN_LEFT_CURLY),
+    SHARED(TOKEN_RIGHT_CURLY),
+};
+#undef SHARED
+
+static bool token_type_shared(enum token_type type) {
+    return type < COUNT(shared_tokens) && shared_tokens[type].type == type;
+}
+
+static struct token* token_shared(enum token_type type) {
+    assert(token_type_shared(type));
+    // Never written through: readers check the type before anything else.
+    return (struct token*)&shared_tokens[type];
+}
+
 static struct token* token_range(struct lexer* L, cp start, cp end) {
 
     struct token* t = token_simple(L, TOKEN_UNICODE_RANGE);
@@ -426,13 +1371,13 @@ static struct token* token_delim(struct lexer* L, cp value) {
     return t;
 }
 
-static struct token* token_new(struct lexer* L, int type, struct buffer* b) {
+static struct token* token_new(struct lexer* L, int type, struct text* b) {
     struct token* t = token_simple(L, type);
 
     t->value.hash.id = L->id;
 
     if (b) {
-        buffer_move(&t->buffer, b);
+        text_move(&t->text, b);
     }
 
     switch (type){
@@ -441,9 +1386,15 @@ static struct token* token_new(struct lexer* L, int type, struct buffer* b) {
             assert(0); // done later
 
         case TOKEN_NUMBER:
-            t->value.number.value = string_to_number(&t->buffer);
-            buffer_init(&t->value.number.unit);
+        {
+            // Number text is never decoded, so it is read from the input.
+            assert(!t->text.decoded);
+            t->value.number.as.digits = L->input + t->text.offset;
+            t->value.number.converted = false;
+            t->value.number.integer = L->integer;
+            text_init(&t->value.number.unit);
             break;
+        }
 
         case TOKEN_DELIM:
             assert(0 && "use delim ctor");
@@ -456,11 +1407,11 @@ static struct token* token_new(struct lexer* L, int type, struct buffer* b) {
     return t;
 }
 
-static struct token* consume_token(struct lexer* L, struct buffer* b);
+static struct token* consume_token(struct lexer* L, struct text* b);
 
 static void lexer_trace(struct lexer* L, const char* state) {
     if (L->logging.trace) {
-        printf("%d:%d %s\n", L->cursor.line, L->cursor.column, state);
+        printf("%zu %s\n", L->current_at, state);
     }
 }
 
@@ -490,37 +1441,28 @@ static bool lexer_valid_escape(struct lexer* L) {
     return valid_escape(L->current, L->next);
 }
 
-static cp peek(FILE* input) {
-    cp result = fgetc(input);
-    ungetcf(result, input);
-    return result;
+static cp peek(struct lexer* L) {
+    return lexer_peek(L, 0);
 }
 
 static bool whitespace(cp c) {
-    switch (c) {
-        case CHAR_LINE_FEED:
-        case CHAR_TABULATION:
-        case CHAR_SPACE:
-            return true;
-        default:
-            return false;
-    }
+    return char_is(c, CLASS_WHITESPACE);
 }
 
-static bool char_letter(cp c) {
-    return isupper(c) || islower(c);
+static bool char_digit(cp c) {
+    return char_is(c, CLASS_DIGIT);
 }
 
-static bool char_non_ascii(int c) {
-    return c >= CHAR_CONTROL;
+static bool char_hex(cp c) {
+    return char_is(c, CLASS_HEX);
 }
 
 static bool char_name_start(cp c){
-    return char_letter(c) || char_non_ascii(c) || c == CHAR_LOW_LINE;
+    return char_is(c, CLASS_NAME_START);
 }
 
 static bool char_name(cp c){
-    return char_name_start(c) || isdigit(c) || c == CHAR_HYPHEN_MINUS;
+    return char_is(c, CLASS_NAME);
 }
 
 // 4.4.5. Check if three characters would start an identifier
@@ -533,8 +1475,9 @@ static bool char_name(cp c){
 // Look at the first character:
 //
 // U+002D HYPHEN-MINUS
-// If the second character is a name-start character or the second and third
-// characters are a valid escape, return true. Otherwise, return false.
+// If the second character is a name-start character or a U+002D HYPHEN-MINUS,
+// or the second and third characters are a valid escape, return true.
+// Otherwise, return false.
 //
 // name-start character
 // Return true.
@@ -546,6 +1489,7 @@ static bool char_name(cp c){
 static bool would_start_ident(cp first, cp second, cp third) {
     if (first == CHAR_HYPHEN_MINUS){
         if (char_name_start(second)) return true;
+        if (second == CHAR_HYPHEN_MINUS) return true; // --custom-property
         if (valid_escape(second, third))  return true;
         return false;
     }
@@ -562,10 +1506,8 @@ static bool would_start_ident(cp first, cp second, cp third) {
 static void lexer_next_three(struct lexer* L, cp r[3])
 {
     r[0] = L->next;
-    r[1] = fgetc(L->input);
-    r[2] = fgetc(L->input);
-    ungetcf(r[2], L->input);
-    ungetcf(r[1], L->input);
+    r[1] = lexer_peek(L, 0);
+    r[2] = lexer_peek(L, 1);
 }
 
 static bool lexer_next_three_are(struct lexer* L, cp a, cp b, cp c) {
@@ -575,7 +1517,7 @@ static bool lexer_next_three_are(struct lexer* L, cp a, cp b, cp c) {
 }
 
 static bool lexer_would_start_ident(struct lexer* L) {
-    return would_start_ident(L->current, L->next, peek(L->input));
+    return would_start_ident(L->current, L->next, peek(L));
 }
 
 static bool lexer_next_would_start_ident(struct lexer* L) {
@@ -601,13 +1543,13 @@ static bool starts_with_number(cp a, cp b, cp c)
         case CHAR_PLUS_SIGN:
         case CHAR_HYPHEN_MINUS:
             // If the second character is a digit, return true.
-            if (isdigit(b)){
+            if (char_digit(b)){
                 return true;
             }
 
             // Otherwise, if the second character is a U+002E FULL STOP (.) and
             // the third character is a digit, return true.
-            if (b == CHAR_FULL_STOP && isdigit(c)){
+            if (b == CHAR_FULL_STOP && char_digit(c)){
                 return true;
             }
 
@@ -615,22 +1557,22 @@ static bool starts_with_number(cp a, cp b, cp c)
 
         case CHAR_FULL_STOP:
             // If the second character is a digit, return true. Otherwise, return false.
-            return isdigit(b);
+            return char_digit(b);
 
         default:
             // digit: Return true.
             // anything else: Return false.
-            return isdigit(a);
+            return char_digit(a);
     }
 }
 
 static bool lexer_starts_with_number(struct lexer* L) {
-    return starts_with_number(L->current, L->next, peek(L->input));
+    return starts_with_number(L->current, L->next, peek(L));
 }
 
 static unsigned char hex_to_byte(cp hex_char){
-    hex_char = toupper(hex_char);
-    return hex_char > '9' ? hex_char - 'A' + 10 : hex_char - '0';
+    assert(char_hex(hex_char));
+    return hex_char <= '9' ? hex_char - '0' : char_lower(hex_char) - 'a' + 10;
 }
 
 // 4.4.1. Consume an escaped character
@@ -658,16 +1600,23 @@ static cp lexer_consume_escape(struct lexer* L) {
     lexer_consume(L);
 
     // not hex
-    if (ishexnumber(L->current)) {
+    if (char_hex(L->current)) {
         // is hex
         cp result = hex_to_byte(L->current);
         for (int i=0; i<5; i++){
-            if (ishexnumber(L->next)){
+            if (char_hex(L->next)){
                 lexer_consume(L);
                 cp n = hex_to_byte(L->current);
-                result = (result << 2) | n;
+                result = (result << 4) | n;
             }
         }
+        if (whitespace(L->next)) {
+            lexer_consume(L);
+        }
+        if (result == 0 || result > CHAR_MAX_CODE_POINT ||
+            (result >= 0xD800 && result <= 0xDFFF)) {
+            return CHAR_REPLACEMENT;
+        }
         return result;
     }
 
@@ -699,15 +1648,17 @@ static cp lexer_consume_escape(struct lexer* L) {
 //   Consume an escaped character. Append the returned character to result.
 // anything else:
 //   Return result.
-static void consume_name(struct lexer* L, struct buffer* b) {
+static void consume_name(struct lexer* L, struct text* b) {
     TRACE(L);
     for (;;) {
-        
+        size_t run = lexer_run(L, name);
+        if (run) lexer_consume_run(L, b, run);
+
         lexer_consume(L);
         if (char_name(L->current)) {
-            buffer_push(b, L->current);
+            text_append(L, b);
         } else if (lexer_valid_escape(L)) {
-            buffer_push(b, lexer_consume_escape(L));
+            text_push(L, b, lexer_consume_escape(L));
         } else {
             // TODO: This seems to break the draft spec:
             // http://dev.w3.org/csswg/css-syntax/#consume-a-token
@@ -717,7 +1668,7 @@ static void consume_name(struct lexer* L, struct buffer* b) {
     }
 }
 
-static struct token* consume_string_token(struct lexer* L, struct buffer* b, cp ending);
+static struct token* consume_string_token(struct lexer* L, struct text* b, cp ending);
 
 static void consume_bad_url_remnants(struct lexer* L) {
 
@@ -735,15 +1686,10 @@ static void consume_bad_url_remnants(struct lexer* L) {
 }
 
 static bool non_printable(cp c){
-    // A character between U+0000 NULL and U+0008 BACKSPACE,
-    if (c <= 8) return true;
-    // LINE TABULATION)
-    if (c == 0xB) return true;
-
-    // U+000E SHIFT OUT and U+001F INFORMATION SEPARATOR ONE
-    if (c >= 0xE && c <= 0x1F) return true;
-    if (c == 0x7F) return true;
-    return false;
+    // A character between U+0000 NULL and U+0008 BACKSPACE, U+000B LINE
+    // TABULATION, a character between U+000E SHIFT OUT and U+001F INFORMATION
+    // SEPARATOR ONE, or U+007F DELETE.
+    return char_is(c, CLASS_NON_PRINTABLE);
 }
 
 static struct token* consume_url(struct lexer* L) {
@@ -755,8 +1701,8 @@ static struct token* consume_url(struct lexer* L) {
         lexer_consume(L);
     }
 
-    struct buffer url;
-    buffer_init(&url);
+    struct text url;
+    text_init(&url);
 
     switch (L->current){
         case CHAR_EOF:
@@ -788,6 +1734,9 @@ static struct token* consume_url(struct lexer* L) {
         }
 
         default:
+            // The loop below starts by consuming, and this is the first
+            // character of the url.
+            lexer_recomsume(L);
             break;
     }
 
@@ -820,13 +1769,14 @@ static struct token* consume_url(struct lexer* L) {
 
             case CHAR_REVERSE_SOLIDUS:
                 if (lexer_valid_escape(L)){
-                    buffer_push(&url, lexer_consume_escape(L));
+                    text_push(L, &url, lexer_consume_escape(L));
                 }
                 else goto url_parse_error;
+                break;
 
             default:
                 if (non_printable(L->current)) goto url_parse_error;
-                buffer_push(&url, L->current);
+                text_append(L, &url);
                 break;
         }
     }
@@ -836,58 +1786,60 @@ url_parse_error:
     return token_new(L, TOKEN_BAD_URL, &url);
 }
 
-static struct token* consume_ident_like(struct lexer* L, struct buffer* b) {
+static unsigned lexer_atom(struct lexer* L, struct text* t) {
+    size_t size;
+    const unsigned char* data = text_data(L->input, t, &size);
+    return atoms_intern(&L->atoms, data, size);
+}
+
+static struct token* token_named(struct lexer* L, int type, struct text* b, unsigned atom) {
+    struct token* t = token_new(L, type, b);
+    t->atom = atom;
+    return t;
+}
+
+static struct token* consume_ident_like(struct lexer* L, struct text* b) {
     TRACE(L);
 
     consume_name(L, b);
+    unsigned atom = lexer_atom(L, b);
 
     if (L->next != CHAR_LEFT_PARENTHESIS) {
-        return token_new(L, TOKEN_IDENT, b);
+        return token_named(L, TOKEN_IDENT, b, atom);
     }
 
-    if (b->size == 3 &&
-        tolower(b->data[0]) == 'u' &&
-        tolower(b->data[1]) == 'r' &&
-        tolower(b->data[2]) == 'l' &&
-        L->next == CHAR_LEFT_PARENTHESIS) {
-
+    if (atom == ATOM_URL) {
         lexer_consume(L);
         return consume_url(L);
     }
 
-    enum token_type type = TOKEN_IDENT;
-
-    if (L->next == CHAR_LEFT_PARENTHESIS) {
-        lexer_consume(L);
-        type = TOKEN_FUNCTION;
-    }
-
-    return token_new(L, type, b);
+    lexer_consume(L);
+    return token_named(L, TOKEN_FUNCTION, b, atom);
 }
 
-static void consume_next_digits(struct lexer* L, struct buffer* b){
-    while(isdigit(L->next)) {
-        buffer_push(b, L->next);
+static void consume_next_digits(struct lexer* L, struct text* b){
+    while(char_digit(L->next)) {
         lexer_consume(L);
+        text_append(L, b);
     }
 }
 
-static struct token* consume_number(struct lexer* L, struct buffer* b) {
+static struct token* consume_number(struct lexer* L, struct text* b) {
     TRACE(L);
     L->integer = true;
 
     if (is_sign(L->next)) {
-        buffer_push(b, L->next);
         lexer_consume(L);
+        text_append(L, b);
     }
 
     consume_next_digits(L, b);
 
-    if (L->next == CHAR_FULL_STOP && isdigit(peek(L->input))) {
-        buffer_push(b, L->next);
+    if (L->next == CHAR_FULL_STOP && char_digit(peek(L))) {
         lexer_consume(L);
-        buffer_push(b, L->next);
+        text_append(L, b);
         lexer_consume(L);
+        text_append(L, b);
         L->integer = false;
 
         consume_next_digits(L, b);
@@ -901,14 +1853,14 @@ static struct token* consume_number(struct lexer* L, struct buffer* b) {
 
         int take = 0;
 
-        if (isdigit(next3[1])) take = 2;
-        if (is_sign(next3[1]) && isdigit(next3[2])) take = 3;
+        if (char_digit(next3[1])) take = 2;
+        if (is_sign(next3[1]) && char_digit(next3[2])) take = 3;
 
         if (take > 0) {
 
             for (int i=0; i<take; i++) {
-                buffer_push(b, L->next);
                 lexer_consume(L);
+                text_append(L, b);
             }
             consume_next_digits(L, b);
             L->integer = false;
@@ -918,19 +1870,20 @@ static struct token* consume_number(struct lexer* L, struct buffer* b) {
     return token_new(L, TOKEN_NUMBER, b);
 }
 
-static struct token* consume_numeric(struct lexer* L, struct buffer* b) {
+static struct token* consume_numeric(struct lexer* L, struct text* b) {
     TRACE(L);
 
     struct token* number = consume_number(L, b);
 
-    if (lexer_would_start_ident(L)) {
+    if (lexer_next_would_start_ident(L)) {
         number->type = TOKEN_DIMENSION;
 
-        struct buffer unit;
+        struct text unit;
 
-        consume_name(L, buffer_init(&unit));
+        consume_name(L, text_init(&unit));
 
-        buffer_move(&number->value.number.unit, &unit);
+        number->atom = lexer_atom(L, &unit);
+        text_move(&number->value.number.unit, &unit);
 
     } else if (L->next == CHAR_PERCENT_SIGN){
         lexer_consume(L);
@@ -948,49 +1901,37 @@ static struct token* consume_numeric(struct lexer* L, struct buffer* b) {
 //
 // Consume the next input character.
 //
-static struct token* state_at_keyword(struct lexer* L, struct buffer* b)
+static struct token* state_at_keyword(struct lexer* L, struct text* b)
 {
     TRACE(L);
-    lexer_consume(L);
 
     // name character:
-    // Append the current input character to the 〈at-keyword〉’s value. Remain
+    // Append the current input character to the 〈at-keyword〉’s value. Remain
     // in this state.
-    if (char_name(L->current)){
-        buffer_push(b, L->current);
-        return state_at_keyword(L, b);
-    }
-
+    //
     // U+005C REVERSE SOLIDUS (\):
-    if (L->current == CHAR_REVERSE_SOLIDUS) {
-        // If the input stream starts with a valid escape, consume an escaped
-        // character Append the returned character to the 〈at-keyword〉’s value.
-        // Remain in this state.
-        if (lexer_valid_escape(L)) {
-            buffer_push(b, lexer_consume_escape(L));
-            return state_at_keyword(L, b);
-        }
-        // Otherwise, emit the 〈at-keyword〉. Switch to the data state. Reconsume
-        // the current input character.
-        lexer_recomsume(L);
-        return token_new(L, TOKEN_AT_KEYWORD, b);
-
-    }
-
+    // If the input stream starts with a valid escape, consume an escaped
+    // character Append the returned character to the 〈at-keyword〉’s value.
+    // Remain in this state. Otherwise, emit the 〈at-keyword〉. Switch to the
+    // data state. Reconsume the current input character.
+    //
     // anything else:
-    // Emit the 〈at-keyword〉. Switch to the data state.
+    // Emit the 〈at-keyword〉. Switch to the data state.
     // Reconsume the current input character.
-    // If this state emits an 〈at-keyword〉 whose value is the empty string, it's
+    //
+    // Which is what consuming a name does, a run at a time.
+    consume_name(L, b);
+
+    // If this state emits an 〈at-keyword〉 whose value is the empty string, it's
     // a spec or implementation error. The data validation performed in the data
     // state should have guaranteed a non-empty value.
-    lexer_recomsume(L);
-    return token_new(L, TOKEN_AT_KEYWORD, b);
+    return token_named(L, TOKEN_AT_KEYWORD, b, lexer_atom(L, b));
 }
 
 static cp unicode_value(struct buffer* start, cp replace) {
     assert(replace == '0' || replace == 'F');
     cp result = 0;
-    for (int i=0; i<start->size; i++) {
+    for (size_t i = 0; i < start->size; i++) {
         cp value = start->data[i];
         if (value == CHAR_QUESTION_MARK) {
             value = replace;
@@ -1005,8 +1946,8 @@ static bool read_range(struct lexer* L, struct buffer* b) {
     assert(b->size == 0);
 
     for (int i=0; i<6; i++) {
-        if (!ishexnumber(L->next)) break;
-        buffer_push(b, L->next);
+        if (!char_hex(L->next)) break;
+        buffer_push(null, b, L->next);
         lexer_consume(L);
     }
 
@@ -1014,7 +1955,7 @@ static bool read_range(struct lexer* L, struct buffer* b) {
 
     for (size_t i = b->size; i<6; i++) {
         if (L->next != CHAR_QUESTION_MARK) break;
-        buffer_push(b, L->next);
+        buffer_push(null, b, L->next);
         lexer_consume(L);
         q_count++;
     }
@@ -1034,7 +1975,7 @@ static void consume_unicode_range_with_buffers(struct lexer* L,
         return;
     }
 
-    if (L->next == CHAR_HYPHEN_MINUS && ishexnumber(peek(L->input))) {
+    if (L->next == CHAR_HYPHEN_MINUS && char_hex(peek(L))) {
         lexer_consume(L); // consume the minus
         has_q = read_range(L, end);
         *low  = unicode_value(start, '0');
@@ -1052,8 +1993,8 @@ static struct token* consume_unicode_range(struct lexer* L) {
     buffer_init(&start);
     buffer_init(&end);
     consume_unicode_range_with_buffers(L, &start, &end, &low, &high);
-    buffer_free(&start);
-    buffer_free(&end);
+    buffer_free(null, &start);
+    buffer_free(null, &end);
     return token_range(L, low, high);
 }
 
@@ -1084,53 +2025,73 @@ static struct token* consume_unicode_range(struct lexer* L) {
 //
 // anything else:
 // Append the current input character to the 〈string〉’s value.
-static struct token* consume_string_token(struct lexer* L, struct buffer* b, cp ending)
+static struct token* consume_string_token(struct lexer* L, struct text* b, cp ending)
 {
     assert(ending == CHAR_APOSTROPHE || ending == CHAR_QUOTATION_MARK);
-    lexer_consume(L);
     TRACE(L);
 
-    if (L->current == CHAR_EOF || L->current == ending) {
-        return token_new(L, TOKEN_STRING, b);
-    }
+    for (;;) {
+        size_t run = lexer_run(L, string, ending);
+        if (run) lexer_consume_run(L, b, run);
 
-    if (L->current == CHAR_LINE_FEED) {
-        return token_new(L, TOKEN_BAD_STRING, b);
-    }
+        lexer_consume(L);
 
-    if (L->current == CHAR_REVERSE_SOLIDUS){
-        if (lexer_valid_escape(L)){
-            buffer_push(b, lexer_consume_escape(L));
-            return consume_string_token(L, b, ending);
+        if (L->current == CHAR_EOF || L->current == ending) {
+            return token_new(L, TOKEN_STRING, b);
         }
 
-        if (L->next == CHAR_LINE_FEED){
-            lexer_consume(L);
-            return consume_string_token(L, b, ending);
+        if (L->current == CHAR_LINE_FEED) {
+            return token_new(L, TOKEN_BAD_STRING, b);
         }
 
-        return token_new(L, TOKEN_BAD_STRING, b);
-    }
+        if (L->current == CHAR_REVERSE_SOLIDUS){
+            if (lexer_valid_escape(L)){
+                text_push(L, b, lexer_consume_escape(L));
+                continue;
+            }
+
+            if (L->next == CHAR_LINE_FEED){
+                lexer_consume(L);
+                continue;
+            }
+
+            return token_new(L, TOKEN_BAD_STRING, b);
+        }
 
-    buffer_push(b, L->current);
-    return consume_string_token(L, b, ending);
+        text_append(L, b);
+    }
 }
 
-static struct token* consume_token(struct lexer* L, struct buffer* b)
+static struct token* consume_token(struct lexer* L, struct text* b)
 {
+    L->space_before = false;
+again:
     TRACE(L);
     lexer_consume(L);
+    L->token_at = L->current_at;
+
+    // Punctuation is a token of the same value on its own.
+    if (char_is(L->current, CLASS_STRUCTURAL)) {
+        return token_shared(L->current);
+    }
 
     switch(L->current) {
 
             // A newline, U+0009 CHARACTER TABULATION, or U+0020 SPACE.
         case CHAR_LINE_FEED:
         case CHAR_TABULATION:
-        case CHAR_SPACE:
+        case CHAR_SPACE: {
+            size_t run = lexer_run(L, whitespace);
+            if (run) lexer_consume_run(L, null, run);
             while(whitespace(L->next)){
                 lexer_consume(L);
             }
-            return token_new(L, TOKEN_WHITESPACE, null);
+            if (L->fold_whitespace) {
+                L->space_before = true;
+                goto again;
+            }
+            return token_shared(TOKEN_WHITESPACE);
+        }
 
             // Fall through for the two string types
         case CHAR_QUOTATION_MARK:
@@ -1144,11 +2105,11 @@ static struct token* consume_token(struct lexer* L, struct buffer* b)
             // flag to "id". Switch to the hash state.
             // Otherwise, emit a 〈delim〉 token with its value set to the current
             // input character. Remain in this state.
-            if (char_name(L->next) || valid_escape(L->next, peek(L->input))) {
+            if (char_name(L->next) || valid_escape(L->next, peek(L))) {
                 L->id = lexer_next_would_start_ident(L);
-                struct buffer buffer;
-                consume_name(L, buffer_init(&buffer));
-                return token_new(L, TOKEN_HASH, &buffer);
+                struct text text;
+                consume_name(L, text_init(&text));
+                return token_new(L, TOKEN_HASH, &text);
             }
 
             return token_delim(L, L->current);
@@ -1156,20 +2117,14 @@ static struct token* consume_token(struct lexer* L, struct buffer* b)
         case CHAR_DOLLAR_SIGN:
             if (L->next == CHAR_EQUALS_SIGN) {
                 lexer_consume(L);
-                return token_simple(L, TOKEN_SUFFIX_MATCH);
+                return token_shared(TOKEN_SUFFIX_MATCH);
             }
             return token_delim(L, L->current);
 
-        case CHAR_LEFT_PARENTHESIS:
-            return token_simple(L, TOKEN_PAREN_LEFT);
-
-        case CHAR_RIGHT_PARENTHESIS:
-            return token_simple(L, TOKEN_PAREN_RIGHT);
-
         case CHAR_ASTERISK:
             if (L->next == CHAR_EQUALS_SIGN) {
                 lexer_consume(L);
-                return token_simple(L, TOKEN_SUBSTRING_MATCH);
+                return token_shared(TOKEN_SUBSTRING_MATCH);
             }
             return token_delim(L, L->current);
 
@@ -1180,27 +2135,24 @@ static struct token* consume_token(struct lexer* L, struct buffer* b)
             }
             return token_delim(L, L->current);
 
-        case CHAR_COMMA:
-            return token_simple(L, TOKEN_COMMA);
-
         case CHAR_HYPHEN_MINUS:
             if (lexer_starts_with_number(L)){
                 lexer_recomsume(L);
                 return consume_numeric(L, b);
             }
 
+            // --> before --ident, which it would otherwise start.
+            if (L->next == CHAR_HYPHEN_MINUS && peek(L) == CHAR_GREATER_THAN) {
+                lexer_consume(L); assert(L->current == CHAR_HYPHEN_MINUS);
+                lexer_consume(L); assert(L->current == CHAR_GREATER_THAN);
+                return token_shared(TOKEN_CDC);
+            }
+
             if (lexer_would_start_ident(L)){
                 lexer_recomsume(L);
                 return consume_ident_like(L, b);
             }
 
-            if (L->next == CHAR_HYPHEN_MINUS && peek(L->input) == CHAR_GREATER_THAN) {
-                lexer_consume(L); assert(L->current == CHAR_HYPHEN_MINUS);
-                lexer_consume(L); assert(L->current == CHAR_GREATER_THAN);
-                lexer_consume(L);
-                return token_simple(L, TOKEN_CDC);
-            }
-
             return token_delim(L, L->current);
 
         case CHAR_FULL_STOP:
@@ -1216,52 +2168,30 @@ static struct token* consume_token(struct lexer* L, struct buffer* b)
 
         case CHAR_SOLIDUS:
             if (L->next == CHAR_ASTERISK) {
-                // Skip a /* comment */
-                // todo: comment token? important comments.
-                if (L->logging.consumtion) {
-                    printf("comment skipping: ");
-                }
-
-                lexer_consume(L);
-                for (;;) {
-                    if (L->logging.consumtion) {
-                        printf("%c", L->next);
-                    }
-                    lexer_consume(L);
-                    if (L->current == CHAR_EOF ||
-                        (L->current == CHAR_ASTERISK && L->next == CHAR_SOLIDUS)){
-                        lexer_consume(L);
-                        break;
-                    }
+                // Skip a /* comment */, unless it is a /*! comment */ that
+                // the lexer was asked to keep. Those usually hold licenses.
+                size_t start = L->current_at;
+                bool important = lexer_peek(L, 0) == CHAR_EXCLAMATION_MARK;
+                size_t end = lexer_skip_comment(L);
+                if (important && L->comments) {
+                    b->offset = start;
+                    b->length = end - start;
+                    return token_new(L, TOKEN_COMMENT, b);
                 }
-                printf("\n");
                 // go again.
-                return consume_token(L, b);
+                goto again;
             }
             return token_delim(L, L->current);
 
-        case CHAR_COLON:
-            return token_simple(L, TOKEN_COLON);
-
-        case CHAR_SEMICOLON:
-            return token_simple(L, TOKEN_SEMICOLON);
-
         case CHAR_LESS_THAN:
             if (lexer_next_three_are(L, CHAR_EXCLAMATION_MARK, CHAR_HYPHEN_MINUS, CHAR_HYPHEN_MINUS)){
                 lexer_consume(L); assert(L->current == CHAR_EXCLAMATION_MARK);
                 lexer_consume(L); assert(L->current == CHAR_HYPHEN_MINUS);
                 lexer_consume(L); assert(L->current == CHAR_HYPHEN_MINUS);
-                lexer_consume(L);
-                return token_simple(L, TOKEN_CDO);
+                return token_shared(TOKEN_CDO);
             }
             return token_delim(L, L->current);
 
-        case CHAR_LEFT_CURLY:
-            return token_simple(L, TOKEN_LEFT_CURLY);
-
-        case CHAR_RIGHT_CURLY:
-            return token_simple(L, TOKEN_RIGHT_CURLY);
-
         case CHAR_COMMERCIAL_AT:
             // If the next 3 input characters would start an identifier, switch
             // to the at-keyword state.
@@ -1274,42 +2204,45 @@ static struct token* consume_token(struct lexer* L, struct buffer* b)
             return token_delim(L, L->current);
 
 
-        case CHAR_LEFT_SQUARE:
-            return token_simple(L, TOKEN_LEFT_SQUARE);
-
-        case CHAR_RIGHT_SQUARE:
-            return token_simple(L, TOKEN_RIGHT_SQUARE);
+        case CHAR_REVERSE_SOLIDUS:
+            // If the input stream starts with a valid escape, reconsume the
+            // current input character and consume an ident-like token.
+            if (lexer_valid_escape(L)) {
+                lexer_recomsume(L);
+                return consume_ident_like(L, b);
+            }
+            return token_delim(L, L->current);
 
         case CHAR_CIRCUMFLEX_ACCENT:
             if (L->next == '='){
                 lexer_consume(L);
-                return token_simple(L, TOKEN_PREFIX_MATCH);
+                return token_shared(TOKEN_PREFIX_MATCH);
             }
             return token_delim(L, L->current);
 
         case CHAR_VERTICAL_LINE:
             if (L->next == '=') {
                 lexer_consume(L);
-                return token_simple(L, TOKEN_DASH_MATCH);
+                return token_shared(TOKEN_DASH_MATCH);
             }
             if (L->next == CHAR_VERTICAL_LINE) {
                 lexer_consume(L);
-                return token_simple(L, TOKEN_COLUMN);
+                return token_shared(TOKEN_COLUMN);
             }
             return token_delim(L, CHAR_VERTICAL_LINE);
 
         case CHAR_TILDE:
             if (L->next == CHAR_EQUALS_SIGN) {
                 lexer_consume(L);
-                return token_simple(L, TOKEN_INCLUDE_MATCH);
+                return token_shared(TOKEN_INCLUDE_MATCH);
             }
             return token_delim(L, CHAR_TILDE);
 
         case CHAR_LATIN_CAPITAL_U:
         case CHAR_LATIN_SMALL_U:
             if (L->next == CHAR_PLUS_SIGN){
-                cp second = peek(L->input);
-                if(ishexnumber(second) || second == CHAR_QUESTION_MARK){
+                cp second = peek(L);
+                if(char_hex(second) || second == CHAR_QUESTION_MARK){
                     // consume the CHAR_PLUS_SIGN
                     lexer_consume(L);
                     return consume_unicode_range(L);
@@ -1320,7 +2253,7 @@ static struct token* consume_token(struct lexer* L, struct buffer* b)
 
 
         case CHAR_EOF:
-            return token_simple(L, TOKEN_EOF);
+            return token_shared(TOKEN_EOF);
 
         default:
             if (char_name_start(L->current)) {
@@ -1328,7 +2261,7 @@ static struct token* consume_token(struct lexer* L, struct buffer* b)
                 return consume_ident_like(L, b);
             }
 
-            if (isdigit(L->current)){
+            if (char_digit(L->current)){
                 lexer_recomsume(L);
                 return consume_numeric(L, b);
             }
@@ -1343,29 +2276,132 @@ static struct token* consume_token(struct lexer* L, struct buffer* b)
 // LEXER  ^^
 // PARSER VV
 
-struct lexer* lexer_init(FILE* input)
+static struct lexer* lexer_new(const void* data, size_t size, enum input_kind kind)
 {
     struct lexer* L = zmalloc(sizeof(struct lexer));
-    L->input   = input;
-    L->next    = fgetc(input);
-    L->cursor.line   = 1;
-    L->cursor.column = 1;
+    L->input    = data;
+    L->size     = size;
+    L->position = 0;
+    L->kind     = kind;
+    L->next     = lexer_preprocess(L, &L->next_at);
+    L->scan     = scanners_select();
+    L->context  = &default_context;
     L->logging.consumtion = false;
     L->logging.trace = false;
-    buffer_logging = false;
+    buffer_init(&L->atoms.text);
     return L;
 }
 
+// Pipes and terminals cannot be mapped, so the whole stream is read into a
+// heap buffer up front and the lexer works on that.
+struct lexer* lexer_init(FILE* input)
+{
+    size_t size = 0;
+    size_t capacity = 64 * 1024;
+    unsigned char* data = zmalloc(capacity);
+
+    for (;;) {
+        size += fread(data + size, 1, capacity - size, input);
+        if (size < capacity) break;
+        capacity *= 2;
+        unsigned char* grown = realloc(data, capacity);
+        if (!grown) {
+            fprintf(stderr, "Error allocating memory");
+            exit(EXIT_FAILURE);
+        }
+        data = grown;
+    }
+
+    if (ferror(input)) {
+        free(data);
+        return null;
+    }
+
+    return lexer_new(data, size, INPUT_OWNED);
+}
+
+struct lexer* lexer_init_memory(const char* data, size_t size)
+{
+    return lexer_new(data, size, INPUT_BORROWED);
+}
+
+struct lexer* lexer_init_mmap(const char* path)
+{
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return null;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return null;
+    }
+
+    // Pipes, like /dev/stdin or <(...), have no size and cannot be mapped.
+    if (!S_ISREG(st.st_mode)) {
+        FILE* file = fdopen(fd, "rb");
+        if (!file) {
+            close(fd);
+            return null;
+        }
+        struct lexer* L = lexer_init(file);
+        fclose(file);
+        return L;
+    }
+
+    // mmap refuses zero length mappings.
+    if (st.st_size == 0) {
+        close(fd);
+        return lexer_new("", 0, INPUT_BORROWED);
+    }
+
+    void* data = mmap(null, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (data == MAP_FAILED) return null;
+
+    posix_madvise(data, st.st_size, POSIX_MADV_SEQUENTIAL);
+    return lexer_new(data, st.st_size, INPUT_MAPPED);
+}
+
+void lexer_free(struct lexer* L)
+{
+    switch (L->kind) {
+        case INPUT_OWNED:
+            free((void*)L->input);
+            break;
+        case INPUT_MAPPED:
+            munmap((void*)L->input, L->size);
+            break;
+        case INPUT_BORROWED:
+            break;
+    }
+    atoms_free(&L->atoms);
+    free(L);
+}
+
+void lexer_preserve_comments(struct lexer* L) {
+    L->comments = true;
+}
+
+void lexer_set_context(struct lexer* L, const struct crush_context* context) {
+    L->context = context;
+    L->comments = context->preserve_comments;
+}
+
 struct token* lexer_next(struct lexer* L)
 {
-    struct buffer buffer;
-    return consume_token(L, buffer_init(&buffer));
+    struct text text;
+    return consume_token(L, text_init(&text));
 }
 
 // Exposed for testing
 double token_number(struct token* t) {
     assert(t->type == TOKEN_NUMBER);
-    return t->value.number.value;
+    return number_value(t);
+}
+
+int token_atom(struct token* t) {
+    return t->atom;
 }
 
 int token_range_low(struct token* t) {
@@ -1378,50 +2414,392 @@ int token_range_high(struct token* t) {
     return t->value.range.end;
 }
 
+// Token tape
+// Tokens are read one at a time as usual, from an arena that is emptied after
+// each, and copied out to the tape's arrays. Each token with more than a type
+// gets a value record; text escapes made differ from the input is copied into
+// the tape's strings.
+
+// Text of a value on the tape: a span of the input, or of tape->strings.
+struct tape_text {
+    size_t offset;
+    size_t length;
+    bool decoded;
+};
+
+struct token_value {
+    struct tape_text text;
+    struct tape_text unit; // dimensions
+    bool flag;             // integer for numbers, id for hashes
+    unsigned atom;
+    cp start;              // the delimiter, or the start of a range
+    cp end;
+};
+
+static void tape_text(struct buffer* strings, struct text* text, struct tape_text* out) {
+    out->decoded = text->decoded;
+    if (text->decoded) {
+        out->offset = strings->size;
+        out->length = text->buffer.size;
+        buffer_append(null, strings, text->buffer.data, text->buffer.size);
+    } else {
+        out->offset = text->offset;
+        out->length = text->length;
+    }
+}
+
+static void tape_value(struct buffer* strings, struct token* t, struct token_value* v) {
+    memset(v, 0, sizeof(*v));
+    tape_text(strings, &t->text, &v->text);
+    v->atom = t->atom;
+
+    switch (t->type) {
+        case TOKEN_NUMBER:
+        case TOKEN_PERCENTAGE:
+        case TOKEN_DIMENSION:
+            v->flag = t->value.number.integer;
+            if (t->type == TOKEN_DIMENSION) {
+                tape_text(strings, &t->value.number.unit, &v->unit);
+            }
+            break;
+        case TOKEN_HASH:
+            v->flag = t->value.hash.id;
+            break;
+        case TOKEN_DELIM:
+            v->start = t->value.delim.value;
+            break;
+        case TOKEN_UNICODE_RANGE:
+            v->start = t->value.range.start;
+            v->end = t->value.range.end;
+            break;
+        default:
+            break;
+    }
+}
+
+struct token_tape* lexer_tokenize_all(struct lexer* L) {
+    struct token_tape* tape = zmalloc(sizeof(struct token_tape));
+    tape->input = L->input;
+    tape->context = L->context;
+
+    size_t capacity = 0, value_capacity = 0;
+    struct buffer strings;
+    buffer_init(&strings);
+
+    struct arena* saved = L->arena;
+    L->arena = arena_new();
+
+    for (;;) {
+        if (tape->count == capacity) {
+            capacity = capacity ? capacity * 2 : 1024;
+            tape->types    = zrealloc(tape->types, capacity * sizeof(*tape->types));
+            tape->offsets  = zrealloc(tape->offsets, capacity * sizeof(*tape->offsets));
+            tape->lengths  = zrealloc(tape->lengths, capacity * sizeof(*tape->lengths));
+            tape->payloads = zrealloc(tape->payloads, capacity * sizeof(*tape->payloads));
+        }
+
+        struct text text;
+        struct token* t = consume_token(L, text_init(&text));
+        size_t i = tape->count++;
+        tape->types[i]    = t->type;
+        tape->offsets[i]  = L->token_at;
+        tape->lengths[i]  = L->next_at - L->token_at;
+        tape->payloads[i] = 0;
+
+        if (!token_type_shared(t->type)) {
+            if (tape->value_count == value_capacity) {
+                value_capacity = value_capacity ? value_capacity * 2 : 1024;
+                tape->values = zrealloc(tape->values, value_capacity * sizeof(*tape->values));
+            }
+            tape->payloads[i] = tape->value_count;
+            tape_value(&strings, t, &tape->values[tape->value_count++]);
+        }
+
+        if (t->type == TOKEN_EOF) break;
+        arena_reset(L->arena);
+    }
+
+    arena_free(L->arena);
+    L->arena = saved;
+
+    tape->strings_size = strings.size;
+    tape->strings = zmalloc(strings.size + 1);
+    memcpy(tape->strings, strings.data, strings.size);
+    buffer_free(null, &strings);
+    return tape;
+}
+
+void token_tape_free(struct token_tape* tape) {
+    free(tape->types);
+    free(tape->offsets);
+    free(tape->lengths);
+    free(tape->payloads);
+    free(tape->values);
+    free(tape->strings);
+    free(tape);
+}
+
+static struct token_value* tape_value_of(struct token_tape* tape, size_t i) {
+    assert(i < tape->count && !token_type_shared(tape->types[i]));
+    return &tape->values[tape->payloads[i]];
+}
+
+static const char* tape_text_data(struct token_tape* tape, struct tape_text* text, size_t* size) {
+    *size = text->length;
+    return (const char*)(text->decoded ? tape->strings : tape->input) + text->offset;
+}
+
+const char* token_tape_text(struct token_tape* tape, size_t i, size_t* size) {
+    return tape_text_data(tape, &tape_value_of(tape, i)->text, size);
+}
+
+const char* token_tape_unit(struct token_tape* tape, size_t i, size_t* size) {
+    assert(tape->types[i] == TOKEN_DIMENSION);
+    return tape_text_data(tape, &tape_value_of(tape, i)->unit, size);
+}
+
+double token_tape_number(struct token_tape* tape, size_t i) {
+    struct token_value* v = tape_value_of(tape, i);
+    assert(tape->types[i] == TOKEN_NUMBER || tape->types[i] == TOKEN_PERCENTAGE ||
+           tape->types[i] == TOKEN_DIMENSION);
+    return string_to_number(tape->input + v->text.offset, v->text.length);
+}
+
+int token_tape_delim(struct token_tape* tape, size_t i) {
+    assert(tape->types[i] == TOKEN_DELIM);
+    return tape_value_of(tape, i)->start;
+}
+
+int token_tape_range_low(struct token_tape* tape, size_t i) {
+    assert(tape->types[i] == TOKEN_UNICODE_RANGE);
+    return tape_value_of(tape, i)->start;
+}
+
+int token_tape_range_high(struct token_tape* tape, size_t i) {
+    assert(tape->types[i] == TOKEN_UNICODE_RANGE);
+    return tape_value_of(tape, i)->end;
+}
+
 
 // Parse
 
+// The tree is flat: a stylesheet keeps its rules and component values in two
+// arrays, and rules, blocks and functions name their children as a run of
+// consecutive component values.
+struct stylesheet {
+    struct rule* rules;
+    size_t rule_count;
+    size_t rule_capacity;
+    struct component_value* values;
+    size_t value_count;
+    size_t value_capacity;
+    size_t grows;                // reallocations of the two arrays
+    const unsigned char* source; // Token text points into this.
+    struct arena* arena;         // Owns the tokens and their buffers.
+};
+
+struct cursor {
+    unsigned line;
+    unsigned column;
+};
+
+// The offsets that lines start at, so that a byte offset can be turned into a
+// line and column without the lexer keeping count as it goes. Line breaks are
+// counted the way preprocessing leaves them: LF, FF, and CR unless a LF
+// follows it.
+struct line_index {
+    size_t* starts; // starts[i] is where line i + 1 begins
+    size_t count;
+};
+
+static void line_index_build(struct line_index* lines, const unsigned char* s, size_t n) {
+    size_t capacity = 64;
+    lines->starts = zmalloc(capacity * sizeof(size_t));
+    lines->starts[0] = 0;
+    lines->count = 1;
+    for (size_t i = 0; i < n; i++) {
+        unsigned char c = s[i];
+        if (c == CHAR_LINE_FEED || c == CHAR_FORM_FEED ||
+            (c == CHAR_CARRIAGE_RETURN && (i + 1 == n || s[i + 1] != CHAR_LINE_FEED))) {
+            if (lines->count == capacity) {
+                capacity *= 2;
+                lines->starts = zrealloc(lines->starts, capacity * sizeof(size_t));
+            }
+            lines->starts[lines->count++] = i + 1;
+        }
+    }
+}
+
+// The line and column of `offset`, columns counting code points.
+static struct cursor line_index_find(struct line_index* lines, const unsigned char* s,
+                                     size_t offset) {
+    size_t low = 0, high = lines->count;
+    while (high - low > 1) {
+        size_t mid = low + (high - low) / 2;
+        if (lines->starts[mid] <= offset) {
+            low = mid;
+        } else {
+            high = mid;
+        }
+    }
+    struct cursor cursor = {(unsigned)low + 1, 1};
+    for (size_t i = lines->starts[low]; i < offset; i++) {
+        if ((s[i] & 0xC0) != 0x80) {
+            cursor.column++;
+        }
+    }
+    return cursor;
+}
+
 struct parser {
     struct token* current;
     struct token* next;
+    bool current_space; // whitespace was skipped to reach current
+    bool next_space;
+    size_t current_end; // input offset just past current
+    size_t next_end;
+
+    // Tokens come from the lexer, or from a tape when there is one.
     struct lexer* lexer;
+    struct token_tape* tape;
+    size_t tape_index;
+
+    const unsigned char* source;
+    size_t source_size;
+    const struct crush_context* context;
+    struct line_index lines; // built by the first parse error
+    size_t rule_end; // input offset just past the last top-level rule to end with }
+    struct stylesheet* ss;
+    struct arena* arena;
+
+    // Component values whose parent is still being parsed.
+    struct component_value* stack;
+    size_t stack_size;
+    size_t stack_capacity;
 };
 
-struct parser* parser_init(struct parser* parser, struct lexer* lexer) {
+struct parser* parser_init(struct parser* parser, struct lexer* lexer, struct token_tape* tape,
+                           struct stylesheet* ss) {
     parser->lexer = lexer;
+    parser->tape = tape;
+    parser->tape_index = 0;
+    parser->source = ss->source;
+    parser->source_size = lexer ? lexer->size : tape->offsets[tape->count - 1];
+    parser->context = lexer ? lexer->context : tape->context;
+    parser->lines = (struct line_index){null, 0};
+    parser->rule_end = 0;
+    parser->ss = ss;
+    parser->arena = ss->arena;
+    parser->stack = null;
+    parser->stack_size = parser->stack_capacity = 0;
     parser->current = parser->next = null;
+    parser->current_space = parser->next_space = false;
     return parser;
 }
 
-struct stylesheet {
-    struct rule* rule;
-};
+static void tape_token_text(struct parser* p, struct tape_text* from, struct text* text) {
+    text_init(text);
+    if (from->decoded) {
+        text->decoded = true;
+        buffer_append(p->arena, &text->buffer, p->tape->strings + from->offset, from->length);
+    } else {
+        text->offset = from->offset;
+        text->length = from->length;
+    }
+}
+
+// The tape's i-th token as the token lexer_next would have given.
+static struct token* tape_token(struct parser* p, size_t i) {
+    enum token_type type = p->tape->types[i];
+    if (token_type_shared(type)) {
+        return token_shared(type);
+    }
+
+    struct token_value* v = tape_value_of(p->tape, i);
+    struct token* t = arena_alloc(p->arena, sizeof(struct token));
+    t->type = type;
+    t->pooled = true;
+    t->atom = v->atom;
+    tape_token_text(p, &v->text, &t->text);
+
+    switch (type) {
+        case TOKEN_NUMBER:
+        case TOKEN_PERCENTAGE:
+        case TOKEN_DIMENSION:
+            t->value.number.integer = v->flag;
+            t->value.number.as.digits = p->source + v->text.offset;
+            tape_token_text(p, &v->unit, &t->value.number.unit);
+            break;
+        case TOKEN_HASH:
+            t->value.hash.id = v->flag;
+            break;
+        case TOKEN_DELIM:
+            t->value.delim.value = v->start;
+            break;
+        case TOKEN_UNICODE_RANGE:
+            t->value.range.start = v->start;
+            t->value.range.end = v->end;
+            break;
+        default:
+            break;
+    }
+    return t;
+}
 
 void parser_consume(struct parser* p) {
     if (p->next) {
         p->current = p->next;
+        p->current_space = p->next_space;
+        p->current_end = p->next_end;
         p->next = null;
+    } else if (p->tape) {
+        // The tape ends with EOF, which is read as often as asked for.
+        size_t i = p->tape_index;
+        if (i + 1 < p->tape->count) p->tape_index++;
+        p->current = tape_token(p, i);
+        p->current_space = false;
+        p->current_end = p->tape->offsets[i] + p->tape->lengths[i];
     } else {
         p->current = lexer_next(p->lexer);
+        p->current_space = p->lexer->space_before;
+        p->current_end = p->lexer->next_at;
     }
 }
 
 void parser_reconsume(struct parser* p) {
     assert(p->next == null);
     p->next = p->current;
+    p->next_space = p->current_space;
+    p->next_end = p->current_end;
     p->current = null;
 }
 
-static void parse_error(struct parser* p, const char* reason) {
+static void report_error(const struct crush_context* context, const char* reason,
+                         unsigned line, unsigned column) {
+    if (context->error) {
+        context->error(context->error_data, reason, line, column);
+        return;
+    }
     fprintf(stderr, "Parse error: %s line:%d column: %d\n",
             reason,
-            p->current->cursor.line,
-            p->current->cursor.column);
+            line,
+            column);
+}
+
+// Errors are rare, so where the current token ends is only turned into a
+// line and column when one is reported.
+static void parse_error(struct parser* p, const char* reason) {
+    if (!p->lines.starts) {
+        line_index_build(&p->lines, p->source, p->source_size);
+    }
+    struct cursor cursor = line_index_find(&p->lines, p->source, p->current_end);
+    report_error(p->context, reason, cursor.line, cursor.column);
 }
 
 enum rule_type {
     RULE_QUALIFIED,
-    RULE_AT
+    RULE_AT,
+    RULE_COMMENT // a preserved comment, the only value in its prelude
 };
 
 enum component_value_type {
@@ -1430,62 +2808,79 @@ enum component_value_type {
     CV_TOKEN
 };
 
+// A run of consecutive component values in the stylesheet's array.
+struct children {
+    size_t first;
+    size_t count;
+};
+
 struct component_value {
-    struct component_value* next;
     enum component_value_type type;
+    bool space_before; // whitespace preceded it in the source
     union {
         struct {
             struct token* name;
-            struct component_value* value;
         } function;
         struct token* token;
         struct {
             enum token_type end;
-            struct component_value* head;
         } block;
-
     } data;
+    struct children children; // blocks and functions
 };
 
 struct rule {
     enum rule_type type; // TODO: can be derived form at_name == null.
-    struct rule* next;
+    bool has_block;
     struct token* at_name;
-    struct component_value* prelude;
-    struct component_value* block;
+    struct children prelude;
+    struct children block; // the values in its {} block
 };
 
-// TODO: This runs order N, should be O(1).
-static struct rule* append_rule(struct rule* head, struct rule* rule) {
-    if (head == null) return rule;
-
-    struct rule* last = head;
-    while(last->next) last = last->next;
-    last->next = rule;
-    return head;
+// Make room for one more item in an array grown by doubling.
+static void* array_reserve(void* data, size_t count, size_t* capacity, size_t size, size_t* grows) {
+    if (count < *capacity) return data;
+    *capacity = *capacity ? *capacity * 2 : 256;
+    if (grows) (*grows)++;
+    return zrealloc(data, *capacity * size);
 }
 
-
 static void parser_skip_ws(struct parser* p) {
+    bool skipped = false;
     while (p->current->type == TOKEN_WHITESPACE) {
         parser_consume(p);
+        skipped = true;
     }
+    // Whitespace itself never reaches the tree; the serializer only needs to
+    // know where it was. A lexer folding whitespace has already said so.
+    p->current_space |= skipped;
 }
 
-void block_append(struct component_value* block, struct component_value* cv) {
-    assert(cv->next == null);
-    if (block->data.block.head == null) {
-        block->data.block.head = cv;
-        return;
-    }
+// Component values are parsed depth first, but the children of each must end
+// up next to each other. So values wait on the parser's stack until their
+// parent is complete, and are then moved to the stylesheet as one run.
+static void parser_push(struct parser* p, struct component_value cv) {
+    p->stack = array_reserve(p->stack, p->stack_size, &p->stack_capacity, sizeof(cv), null);
+    p->stack[p->stack_size++] = cv;
+}
 
-    struct component_value* i = block->data.block.head;
-    while(i->next) i = i->next;
-    i->next = cv;
+// Move the values pushed since the stack held `mark` to the stylesheet.
+static struct children parser_collect(struct parser* p, size_t mark) {
+    struct stylesheet* ss = p->ss;
+    struct children children = {ss->value_count, p->stack_size - mark};
+
+    if (children.count == 0) return children;
+    while (ss->value_capacity - ss->value_count < children.count) {
+        ss->values = array_reserve(ss->values, ss->value_capacity, &ss->value_capacity,
+                                   sizeof(struct component_value), &ss->grows);
+    }
+    memcpy(ss->values + ss->value_count, p->stack + mark, children.count * sizeof(struct component_value));
+    ss->value_count += children.count;
+    p->stack_size = mark;
+    return children;
 }
 
-static struct component_value* consume_component_value(struct parser* p);
-static void append_token_to_prelude(struct rule* rule, struct component_value* cv);
+static void consume_component_value(struct parser* p);
 
 static enum token_type mirror_of(enum token_type t) {
     switch (t) {
@@ -1501,28 +2896,93 @@ static enum token_type mirror_of(enum token_type t) {
     }
 }
 
-static struct component_value* component_value_new(enum component_value_type type){
-    struct component_value* cv = zmalloc(sizeof(struct component_value));
-    cv->type = type;
-    return cv;
+static bool cv_is(struct component_value* cv, enum token_type type) {
+    return cv && cv->type == CV_TOKEN && cv->data.token->type == type;
 }
 
-static struct component_value* component_value_new_token(struct token* token) {
-    struct component_value* result = component_value_new(CV_TOKEN);
-    result->data.token = token;
-    return result;
+// Custom properties hold a plain list of tokens, {} blocks included, so their
+// values are kept as written.
+static bool custom_property(const unsigned char* source, struct token* property) {
+    size_t size;
+    const unsigned char* data = text_data(source, &property->text, &size);
+    return size >= 2 && data[0] == CHAR_HYPHEN_MINUS && data[1] == CHAR_HYPHEN_MINUS;
 }
 
-static struct component_value* component_value_new_block(enum token_type start) {
-    struct component_value* block = component_value_new(CV_BLOCK);
-    block->data.block.end = mirror_of(start);
-    return block;
-}
+// Where the component values of a {} block are among its declarations: the
+// property once its name has been seen, and whether its value has started.
+struct declaration {
+    struct token* property;
+    bool value;
+    bool custom; // the property is a custom property
+};
 
+static void declaration_next(struct declaration* d, const unsigned char* source,
+                             struct component_value* cv) {
+    // A nested rule's block ends its statement as a semicolon does, but a
+    // custom property's value can hold a {} block.
+    if (cv_is(cv, TOKEN_SEMICOLON) ||
+        (cv->type == CV_BLOCK && cv->data.block.end == TOKEN_RIGHT_CURLY &&
+         !(d->value && d->custom))) {
+        d->property = null;
+        d->value = false;
+        d->custom = false;
+    } else if (!d->value && cv_is(cv, TOKEN_COLON)) {
+        d->value = d->property != null;
+    } else if (!d->value && !d->property && cv_is(cv, TOKEN_IDENT)) {
+        d->property = cv->data.token;
+        d->custom = custom_property(source, d->property);
+    }
+}
+
+static struct component_value* skip_comments(struct component_value* cv,
+                                             struct component_value* last) {
+    while (cv < last && cv_is(cv, TOKEN_COMMENT)) cv++;
+    return cv;
+}
+
+// Whether the statement starting at `cv` in a {} block is a nested rule: a
+// prelude that runs up to a {} block rather than a declaration up to a
+// semicolon. Nested at-rules have a prelude too, but not a selector, and a
+// custom property is a declaration whatever its value holds.
+static bool nested_rule(const unsigned char* source, struct component_value* cv,
+                        struct component_value* last) {
+    cv = skip_comments(cv, last);
+    if (cv == last || cv_is(cv, TOKEN_AT_KEYWORD)) return false;
+    if (cv_is(cv, TOKEN_IDENT) && custom_property(source, cv->data.token)) {
+        struct component_value* next = skip_comments(cv + 1, last);
+        if (next < last && cv_is(next, TOKEN_COLON)) return false;
+    }
+
+    for (; cv < last; cv++) {
+        if (cv_is(cv, TOKEN_SEMICOLON)) return false;
+        if (cv->type == CV_BLOCK && cv->data.block.end == TOKEN_RIGHT_CURLY) return true;
+    }
+    return false;
+}
+
+static struct component_value component_value_new(enum component_value_type type) {
+    struct component_value cv = {0};
+    cv.type = type;
+    return cv;
+}
+
+static struct component_value component_value_new_token(struct token* token) {
+    struct component_value result = component_value_new(CV_TOKEN);
+    result.data.token = token;
+    return result;
+}
+
+static struct component_value component_value_new_block(enum token_type start) {
+    struct component_value block = component_value_new(CV_BLOCK);
+    block.data.block.end = mirror_of(start);
+    return block;
+}
 
-static struct component_value* consume_simple_block(struct parser* p, enum token_type start) {
 
-    struct component_value* block = component_value_new_block(start);
+static struct component_value consume_simple_block(struct parser* p, enum token_type start) {
+
+    struct component_value block = component_value_new_block(start);
+    size_t mark = p->stack_size;
 
     for (;;){
         parser_consume(p);
@@ -1532,115 +2992,108 @@ static struct component_value* consume_simple_block(struct parser* p, enum token
         parser_skip_ws(p);
 
         if (p->current->type == TOKEN_EOF ||
-            p->current->type == block->data.block.end) {
+            p->current->type == block.data.block.end) {
+            block.children = parser_collect(p, mark);
             return block;
         }
         parser_reconsume(p);
-        block_append(block, consume_component_value(p));
-    }
-
-    NEVER_RETURN();
-}
-
-static void function_append(struct component_value* f, struct component_value* value) {
-    assert(f->type == CV_FUNCTION);
-    if(f->data.function.value == null) {
-        f->data.function.value = value;
-        return;
+        consume_component_value(p);
     }
-    struct component_value* cv = f->data.function.value;
-    while(cv->next) cv = cv->next;
-    cv->next = value;
 }
 
-static void* consume_function(struct parser* p) {
-    struct component_value* result = component_value_new(CV_FUNCTION);
-    result->data.function.name = p->current;
+static struct component_value consume_function(struct parser* p) {
+    struct component_value result = component_value_new(CV_FUNCTION);
+    size_t mark = p->stack_size;
+    result.data.function.name = p->current;
 
     for (;;){
         parser_consume(p);
+        parser_skip_ws(p);
         switch (p->current->type) {
             case TOKEN_EOF:
             case TOKEN_PAREN_RIGHT:
+                result.children = parser_collect(p, mark);
                 return result;
 
             default:
                 parser_reconsume(p);
-                function_append(result, consume_component_value(p));
+                consume_component_value(p);
                 break;
         }
     }
-    
-    NEVER_RETURN();
 }
 
-static struct component_value* consume_component_value(struct parser* p){
+// Pushes the value on the parser's stack.
+static void consume_component_value(struct parser* p){
     parser_consume(p);
     parser_skip_ws(p);
+
+    struct component_value result;
+    bool space_before = p->current_space;
     switch (p->current->type) {
         case TOKEN_LEFT_CURLY:
         case TOKEN_LEFT_SQUARE:
         case TOKEN_PAREN_LEFT:
-            return consume_simple_block(p, p->current->type);
+            result = consume_simple_block(p, p->current->type);
+            break;
 
         case TOKEN_FUNCTION:
-            return consume_function(p);
+            result = consume_function(p);
+            break;
 
         default:
-            return component_value_new_token(p->current);
+            result = component_value_new_token(p->current);
+            break;
     }
-    NEVER_RETURN();
+    result.space_before = space_before;
+    parser_push(p, result);
 }
 
-static struct rule* rule_new(enum rule_type type) {
-    struct rule* rule = zmalloc(sizeof(struct rule));
+// Rules are appended to the stylesheet as they start. Nothing a rule holds is
+// a rule itself, so the one being parsed stays the last.
+static struct rule* rule_new(struct parser* p, enum rule_type type) {
+    struct stylesheet* ss = p->ss;
+    ss->rules = array_reserve(ss->rules, ss->rule_count, &ss->rule_capacity,
+                              sizeof(struct rule), &ss->grows);
+    struct rule* rule = &ss->rules[ss->rule_count++];
+    memset(rule, 0, sizeof(*rule));
     rule->type = type;
     return rule;
 }
 
-static struct rule* consume_at_rule(struct parser* p) {
+static void consume_at_rule(struct parser* p) {
 
     // TODO: This consume is not really mentioned in 5.4.2 Consume an at-rule
     parser_consume(p);
 
-    struct rule* rule = rule_new(RULE_AT);
+    struct rule* rule = rule_new(p, RULE_AT);
+    size_t mark = p->stack_size;
     rule->at_name = p->current;
 
     for (;;) {
 
         parser_consume(p);
+        parser_skip_ws(p);
 
         switch(p->current->type) {
             case TOKEN_SEMICOLON:
             case TOKEN_EOF:
-                return rule;
+                rule->prelude = parser_collect(p, mark);
+                return;
             case TOKEN_LEFT_CURLY:
-                rule->block = consume_simple_block(p, TOKEN_LEFT_CURLY);
-                return rule;
+                rule->prelude = parser_collect(p, mark);
+                rule->block = consume_simple_block(p, TOKEN_LEFT_CURLY).children;
+                rule->has_block = true;
+                return;
             // case simple block:
             default:
-                // TODO: Whitespace comes through here.
                 parser_reconsume(p);
-                append_token_to_prelude(rule, consume_component_value(p));
+                consume_component_value(p);
                 break;
         }
     }
 }
 
-static void append_token_to_prelude(struct rule* rule, struct component_value* cv) {
-    assert(cv->next == null);
-
-    if (!rule->prelude) {
-        rule->prelude = cv;
-        return;
-    }
-
-    struct component_value* i = rule->prelude;
-    while(i->next)  i = i->next;
-    assert(i->next == null);
-    i->next = cv;
-}
-
 // 5.4.3 Consume a qualified rule
 // Create a new qualified rule with its prelude initially set to an empty list,
 // and its value initially set to nothing.
@@ -1659,9 +3112,10 @@ static void append_token_to_prelude(struct rule* rule, struct component_value* c
 // anything else:
 // Reconsume the current input token. Consume a component value. Append the
 // returned value to the qualified rule's prelude.
-static struct rule* consume_qualified_rule(struct parser* p) {
+static void consume_qualified_rule(struct parser* p) {
 
-    struct rule* result = rule_new(RULE_QUALIFIED);
+    struct rule* result = rule_new(p, RULE_QUALIFIED);
+    size_t mark = p->stack_size;
 
     for (;;)
     {
@@ -1676,183 +3130,1908 @@ static struct rule* consume_qualified_rule(struct parser* p) {
             case TOKEN_EOF:
                 parse_error(p, "Unexepected end of input");
                 // parse error
-                return null;
+                p->stack_size = mark;
+                p->ss->rule_count--;
+                return;
 
             case TOKEN_LEFT_CURLY:
-                result->block = consume_simple_block(p, TOKEN_LEFT_CURLY);
-                return result;
+                result->prelude = parser_collect(p, mark);
+                result->block = consume_simple_block(p, TOKEN_LEFT_CURLY).children;
+                result->has_block = true;
+                return;
 
             // case simple block
             // TODO. handle this.
 
             default:
                 parser_reconsume(p);
-                append_token_to_prelude(result, consume_component_value(p));
+                consume_component_value(p);
                 break;
         }
     }
-    NEVER_RETURN();
+}
+
+static void consume_comment(struct parser* p) {
+    struct rule* rule = rule_new(p, RULE_COMMENT);
+    size_t mark = p->stack_size;
+    parser_push(p, component_value_new_token(p->current));
+    rule->prelude = parser_collect(p, mark);
 }
 
 // TODO: Is top level always true for documents?
-static struct rule* consume_list_of_rules(struct parser* p, bool top_level)
+static void consume_list_of_rules(struct parser* p, bool top_level)
 {
-    struct rule* result = null;
-    
     for (;;) {
 
         parser_consume(p);
 
+        // Whitespace between rules is dropped without a trace.
+        p->current_space = false;
+
         switch (token_type(p->current)) {
             case TOKEN_WHITESPACE:
                 break;
 
             case TOKEN_EOF:
-                return result;
+                return;
 
             case TOKEN_CDC:
             case TOKEN_CDO:
                 // If the top-level flag is set, do nothing.
                 if (top_level) break;
                 parser_reconsume(p);
-                append_rule(result, consume_qualified_rule(p));
+                consume_qualified_rule(p);
                 break;
 
             case TOKEN_AT_KEYWORD:
                 parser_reconsume(p);
-                result = append_rule(result, consume_at_rule(p));
+                consume_at_rule(p);
+                break;
+
+            case TOKEN_COMMENT:
+                consume_comment(p);
                 break;
 
             default:
                 parser_reconsume(p);
-                result = append_rule(result, consume_qualified_rule(p));
+                consume_qualified_rule(p);
                 break;
 
         }
+
+        // Parallel parsing cuts the input where a rule's block closed.
+        if (top_level && token_type(p->current) == TOKEN_RIGHT_CURLY) {
+            p->rule_end = p->current_end;
+        }
     }
-    NEVER_RETURN();
+}
+
+static struct stylesheet* stylesheet_new(const unsigned char* source) {
+    struct stylesheet* result = zmalloc(sizeof(struct stylesheet));
+    result->arena = arena_new();
+    result->source = source;
+    return result;
+}
+
+static void parse(struct parser* parser) {
+    consume_list_of_rules(parser, true);
+    free(parser->stack);
+    free(parser->lines.starts);
+}
+
+// Empty `ss` for another parse, keeping its newest arena block and the room
+// in its arrays.
+static struct stylesheet* stylesheet_reset(struct stylesheet* ss, const unsigned char* source) {
+    arena_reset(ss->arena);
+    ss->arena->allocations = 0;
+    ss->arena->blocks = 0;
+    ss->rule_count = ss->value_count = 0;
+    ss->grows = 0;
+    ss->source = source;
+    return ss;
 }
 
 struct stylesheet* parse_stylesheet(struct lexer* L) {
+    return parse_stylesheet_reusing(L, null);
+}
+
+struct stylesheet* parse_stylesheet_reusing(struct lexer* L, struct stylesheet* reuse) {
     struct parser parser;
+    struct stylesheet* result = reuse ? stylesheet_reset(reuse, L->input) : stylesheet_new(L->input);
+
+    // Tokens read during the parse belong to the stylesheet, and whitespace
+    // is only a flag on the token after it.
+    struct arena* saved = L->arena;
+    bool fold_whitespace = L->fold_whitespace;
+    L->arena = result->arena;
+    L->fold_whitespace = true;
+    parse(parser_init(&parser, L, null, result));
+    L->arena = saved;
+    L->fold_whitespace = fold_whitespace;
 
-    struct stylesheet* result = zmalloc(sizeof(struct stylesheet));
+    return result;
+}
 
-    result->rule = consume_list_of_rules(parser_init(&parser, L), true);
+struct stylesheet* parse_token_tape(struct token_tape* tape) {
+    struct parser parser;
+    struct stylesheet* result = stylesheet_new(tape->input);
+    parse(parser_init(&parser, null, tape, result));
     return result;
 }
 
-static void ss_print_component_value(struct component_value* cv, FILE* file);
+void stylesheet_free(struct stylesheet* ss) {
+    arena_free(ss->arena);
+    free(ss->rules);
+    free(ss->values);
+    free(ss);
+}
 
-static void ss_print_token(struct token* token, FILE* file) {
-    switch (token->type) {
-        case TOKEN_COLON:
-        case TOKEN_SEMICOLON:
-        case TOKEN_COMMA:
-        case TOKEN_LEFT_SQUARE:
-        case TOKEN_RIGHT_SQUARE:
-        case TOKEN_PAREN_LEFT:
-        case TOKEN_PAREN_RIGHT:
-        case TOKEN_LEFT_CURLY:
-        case TOKEN_RIGHT_CURLY:
-            fputc(token->type, file);
-            break;
+void stylesheet_stats(struct stylesheet* ss, struct crush_stats* stats) {
+    stats->allocations = ss->arena->allocations + ss->rule_count + ss->value_count;
+    stats->mallocs     = ss->arena->blocks + ss->grows;
+    stats->bytes       = ss->arena->bytes + ss->rule_capacity * sizeof(struct rule) +
+                         ss->value_capacity * sizeof(struct component_value);
+}
 
-        case TOKEN_IDENT:
-        case TOKEN_NUMBER:
-        case TOKEN_PERCENTAGE:
-            buffer_print(file, token);
-            break;
+static size_t atoms_of(struct stylesheet* ss, struct children children, int* atoms, size_t max,
+                       size_t count) {
+    for (size_t i = 0; i < children.count; i++) {
+        struct component_value* cv = &ss->values[children.first + i];
+        struct token* named = cv->type == CV_TOKEN ? cv->data.token
+                            : cv->type == CV_FUNCTION ? cv->data.function.name : null;
+        if (named && named->atom != NO_ATOM) {
+            if (count < max) atoms[count] = named->atom;
+            count++;
+        }
+        if (cv->type != CV_TOKEN) {
+            count = atoms_of(ss, cv->children, atoms, max, count);
+        }
+    }
+    return count;
+}
 
-        case TOKEN_HASH:
-            buffer_print(file, token);
-            break;
+size_t stylesheet_atoms(struct stylesheet* ss, int* atoms, size_t max) {
+    size_t count = 0;
+    for (size_t i = 0; i < ss->rule_count; i++) {
+        struct rule* rule = &ss->rules[i];
+        if (rule->at_name) {
+            if (count < max) atoms[count] = rule->at_name->atom;
+            count++;
+        }
+        count = atoms_of(ss, rule->prelude, atoms, max, count);
+        if (rule->has_block) {
+            count = atoms_of(ss, rule->block, atoms, max, count);
+        }
+    }
+    return count;
+}
 
-        case TOKEN_AT_KEYWORD:
-            fputc('@', file);
-            buffer_print(file, token);
-            break;
+// Parallel parse
+// A large input is cut into pieces that each end just after a top-level rule's
+// closing brace, the pieces are parsed on threads of their own, and their
+// rules and component values are joined in order. The cuts come from a quick
+// pass that follows strings, comments, escapes, urls and bracket nesting
+// without tokenizing, so one could land where the tokenizer would not have
+// ended a rule. A piece is only kept if its parse ended with a top-level rule
+// closing exactly at its end, which is where the sequential parse is then as
+// well; from the first piece that did not, the rest of the input is parsed
+// again in one go. Each piece's lexer numbers the names it meets itself, so
+// once it is known which pieces are kept their names are interned in L's
+// table in input order, which gives them the atoms the sequential parse does.
+
+enum { PIECE_MIN = 256 * 1024, PIECES_PER_THREAD = 4, SPLIT_DEPTH = 256 };
+
+// Whether the `(` at s[i] ends the name `url`, opening what may be an unquoted
+// url rather than a block.
+static bool split_url(const unsigned char* s, size_t i) {
+    if (i < 3 || char_lower(s[i - 3]) != 'u' || char_lower(s[i - 2]) != 'r' ||
+        char_lower(s[i - 1]) != 'l') {
+        return false;
+    }
+    return i == 3 || !(char_name(s[i - 4]) || s[i - 4] == '\\');
+}
 
-        case TOKEN_DELIM:
-            fputc(token->value.delim.value, file);
-            break;
+// Offsets just past the closing brace of a top-level rule, the first at or
+// beyond each of `count` evenly spaced targets, skipping targets an earlier
+// one already passed. Returns how many were found.
+static size_t split_points(const unsigned char* s, size_t n, size_t* splits, size_t count) {
+    unsigned char closers[SPLIT_DEPTH];
+    size_t depth = 0, found = 0, k = 0;
+    size_t spacing = n / (count + 1); // target k is at spacing * (k + 1)
+
+    for (size_t i = 0; i < n; i++) {
+        unsigned char c = s[i];
+        switch (c) {
+            case '/':
+                if (i + 1 < n && s[i + 1] == '*') {
+                    for (i += 2; i + 1 < n && !(s[i] == '*' && s[i + 1] == '/'); i++) {}
+                    if (i + 1 >= n) return found;
+                    i++;
+                }
+                break;
 
-        case TOKEN_URL:
-            fputs("url(\"", file);
-            buffer_print(file, token);
-            fputs("\")", file);
-            break;
+            case '"':
+            case '\'':
+                for (i++; i < n && s[i] != c; i++) {
+                    if (s[i] == '\\') {
+                        i += i + 2 < n && s[i + 1] == '\r' && s[i + 2] == '\n' ? 2 : 1;
+                    } else if (s[i] == '\n' || s[i] == '\r' || s[i] == '\f') {
+                        break;
+                    }
+                }
+                break;
 
-        case TOKEN_STRING:
-            fputs("\"", file);
-            buffer_print(file, token);
-            fputs("\"", file);
-            break;
-            
-        case TOKEN_EOF:
-            break;
+            case '\\':
+                i++;
+                break;
 
-        default:
-            assert(0);
+            case '(':
+                if (split_url(s, i)) {
+                    size_t j = i + 1;
+                    while (j < n && whitespace(s[j])) j++;
+                    if (j < n && s[j] != '"' && s[j] != '\'') {
+                        for (; j < n && s[j] != ')'; j++) {
+                            if (s[j] == '\\') j++;
+                        }
+                        i = j;
+                        break;
+                    }
+                }
+                // fallthrough
+            case '[':
+            case '{':
+                if (depth == SPLIT_DEPTH) return found;
+                closers[depth++] = c == '(' ? ')' : c == '[' ? ']' : '}';
+                break;
+
+            case ')':
+            case ']':
+            case '}':
+                if (depth == 0 || closers[depth - 1] != c) break;
+                depth--;
+                if (depth == 0 && c == '}' && i + 1 >= spacing * (k + 1)) {
+                    splits[found++] = i + 1;
+                    while (k < count && spacing * (k + 1) <= i + 1) k++;
+                    if (k == count) return found;
+                }
+                break;
+        }
+    }
+    return found;
+}
+
+struct held_error {
+    const char* reason;
+    unsigned line;
+    unsigned column;
+};
+
+struct piece {
+    size_t begin;
+    size_t end;
+    struct stylesheet* ss;
+    bool closed; // a top-level rule ended at `end`
+    size_t rule_base;  // where its rules and component values go when joined
+    size_t value_base;
+    struct lexer* lexer; // the table its atoms are in
+    unsigned* atoms;     // their atoms in L's table, null if the same
+
+    // Errors wait until it is known whether the piece is kept.
+    struct crush_context context;
+    struct held_error* errors;
+    size_t error_count;
+};
+
+static void hold_error(void* data, const char* reason, unsigned line, unsigned column) {
+    struct piece* piece = data;
+    piece->errors = zrealloc(piece->errors, (piece->error_count + 1) * sizeof(struct held_error));
+    piece->errors[piece->error_count++] = (struct held_error){reason, line, column};
+}
+
+// Parse input[begin, end) of `from`'s input with its options, on a lexer of
+// its own, and set `rule_end` to where the last top-level rule ending with }
+// ended. Returns the lexer, which holds the stylesheet's atoms, for the caller
+// to free.
+static struct lexer* parse_range(struct lexer* from, const struct crush_context* context,
+                                 size_t begin, size_t end, struct stylesheet** result,
+                                 size_t* rule_end) {
+    struct lexer* L = lexer_new(from->input, end, INPUT_BORROWED);
+    L->position = begin;
+    L->next = lexer_preprocess(L, &L->next_at);
+    L->comments = from->comments;
+    L->context = context;
+
+    struct stylesheet* ss = stylesheet_new(from->input);
+    L->arena = ss->arena;
+    L->fold_whitespace = true;
+    struct parser parser;
+    parse(parser_init(&parser, L, null, ss));
+
+    *result = ss;
+    *rule_end = parser.rule_end;
+    return L;
+}
+
+static void token_renumber(struct token* t, const unsigned* atoms) {
+    if (t->atom >= ATOM_KEYWORD_COUNT) t->atom = atoms[t->atom - ATOM_KEYWORD_COUNT];
+}
+
+// Move the names of `ss` to the atoms `atoms_merge` gave them.
+static void stylesheet_renumber(struct stylesheet* ss, const unsigned* atoms) {
+    for (size_t i = 0; i < ss->value_count; i++) {
+        struct component_value* cv = &ss->values[i];
+        if (cv->type == CV_TOKEN) {
+            token_renumber(cv->data.token, atoms);
+        } else if (cv->type == CV_FUNCTION) {
+            token_renumber(cv->data.function.name, atoms);
+        }
+    }
+    for (size_t i = 0; i < ss->rule_count; i++) {
+        if (ss->rules[i].at_name) token_renumber(ss->rules[i].at_name, atoms);
     }
-    fputc(' ', file);
 }
 
-static void ss_print_block(cp end, struct component_value* cv, FILE* file) {
-    fputc(mirror_of(end), file);
-    for (struct component_value* i = cv; i; i = i->next) {
-        ss_print_component_value(i, file);
+// Make room for `rules` more rules and `values` more component values.
+static void stylesheet_reserve(struct stylesheet* ss, size_t rules, size_t values) {
+    if (ss->value_capacity < ss->value_count + values) {
+        ss->value_capacity = ss->value_count + values;
+        ss->values = zrealloc(ss->values, ss->value_capacity * sizeof(struct component_value));
+        ss->grows++;
+    }
+    if (ss->rule_capacity < ss->rule_count + rules) {
+        ss->rule_capacity = ss->rule_count + rules;
+        ss->rules = zrealloc(ss->rules, ss->rule_capacity * sizeof(struct rule));
+        ss->grows++;
     }
-    fputc(end, file);
-    fputc('\n', file);
 }
 
-static void ss_print_function(struct token* name, struct component_value* value, FILE* file) {
-    buffer_print(file, name);
-    fputs("(", file);
-    for(struct component_value* cv = value; cv; cv = cv->next) {
-        ss_print_component_value(cv, file);
+// Copy `from`'s rules and component values into room already made in `to`,
+// at the given indexes, pointing children at their new places.
+static void stylesheet_copy(struct stylesheet* to, struct stylesheet* from,
+                            size_t rule_base, size_t value_base) {
+    for (size_t i = 0; i < from->value_count; i++) {
+        struct component_value* cv = &to->values[value_base + i];
+        *cv = from->values[i];
+        cv->children.first += value_base;
+    }
+    for (size_t i = 0; i < from->rule_count; i++) {
+        struct rule* rule = &to->rules[rule_base + i];
+        *rule = from->rules[i];
+        rule->prelude.first += value_base;
+        rule->block.first += value_base;
     }
-    fputs(")", file);
 }
 
-static void ss_print_component_value(struct component_value* cv, FILE* file) {
-    switch (cv->type) {
-        case CV_TOKEN:
-            ss_print_token(cv->data.token, file);
-            break;
-        case CV_BLOCK:
-            ss_print_block(cv->data.block.end, cv->data.block.head, file);
-            break;
-        case CV_FUNCTION:
-            ss_print_function(cv->data.function.name,
-                              cv->data.function.value, file);
-            break;
+// Hand `from`'s arena over to `to`, once its rules and values are copied, and
+// free the rest of it.
+static void stylesheet_adopt(struct stylesheet* to, struct stylesheet* from) {
+    // Blocks go behind the one `to` is filling.
+    struct arena* a = to->arena;
+    struct arena* b = from->arena;
+    if (b->head) {
+        struct arena_block* last = b->head;
+        while (last->next) last = last->next;
+        if (a->head) {
+            last->next = a->head->next;
+            a->head->next = b->head;
+        } else {
+            a->head = b->head;
+        }
+        b->head = null;
     }
+    a->allocations += b->allocations;
+    a->blocks += b->blocks;
+    a->bytes += b->bytes;
+    to->grows += from->grows;
+    stylesheet_free(from);
 }
 
-static void ss_print_rule(struct rule* rule, FILE* file) {
+struct parallel {
+    struct lexer* L;
+    struct piece* pieces;
+    struct stylesheet* result;
+    void (*task)(struct parallel* work, size_t i);
+    size_t tasks;
+    size_t next; // the first task no thread has taken
+    pthread_mutex_t lock;
+};
 
-    if (rule->type == RULE_AT) {
-        assert(rule->at_name);
-        ss_print_token(rule->at_name, file);
+static void* run_tasks(void* arg) {
+    struct parallel* work = arg;
+    for (;;) {
+        pthread_mutex_lock(&work->lock);
+        size_t i = work->next++;
+        pthread_mutex_unlock(&work->lock);
+        if (i >= work->tasks) break;
+        work->task(work, i);
+    }
+    return null;
+}
+
+// Run `task` for each of 0 to `tasks` - 1 on up to `threads` threads. The
+// calling thread is one of them, and takes on the tasks of any that could not
+// be started.
+static void run_on_threads(struct parallel* work, unsigned threads,
+                           void (*task)(struct parallel* work, size_t i), size_t tasks) {
+    work->task = task;
+    work->tasks = tasks;
+    work->next = 0;
+    if (threads > tasks) threads = tasks;
+
+    pthread_t* ids = zmalloc(threads * sizeof(pthread_t));
+    unsigned started = 1;
+    while (started < threads && pthread_create(&ids[started], null, run_tasks, work) == 0) {
+        started++;
+    }
+    run_tasks(work);
+    for (unsigned i = 1; i < started; i++) {
+        pthread_join(ids[i], null);
     }
+    free(ids);
+}
+
+static void parse_piece(struct parallel* work, size_t i) {
+    struct piece* piece = &work->pieces[i];
+    size_t rule_end;
+    piece->lexer = parse_range(work->L, &piece->context, piece->begin, piece->end, &piece->ss,
+                               &rule_end);
+    piece->closed = rule_end == piece->end;
+}
+
+static void copy_piece(struct parallel* work, size_t i) {
+    struct piece* piece = &work->pieces[i];
+    if (piece->atoms) {
+        stylesheet_renumber(piece->ss, piece->atoms);
+    }
+    if (piece->ss != work->result) {
+        stylesheet_copy(work->result, piece->ss, piece->rule_base, piece->value_base);
+    }
+}
+
+struct stylesheet* parse_stylesheet_parallel(struct lexer* L, unsigned threads) {
+    size_t wanted = (size_t)threads * PIECES_PER_THREAD;
+    if (wanted > L->size / PIECE_MIN) wanted = L->size / PIECE_MIN;
+    if (threads < 2 || wanted < 2) return parse_stylesheet(L);
+
+    size_t* splits = zmalloc((wanted - 1) * sizeof(size_t));
+    size_t count = split_points(L->input, L->size, splits, wanted - 1) + 1;
+    if (count < 2) {
+        free(splits);
+        return parse_stylesheet(L);
+    }
+
+    struct piece* pieces = zmalloc(count * sizeof(struct piece));
+    for (size_t i = 0; i < count; i++) {
+        pieces[i].begin = i ? splits[i - 1] : 0;
+        pieces[i].end = i + 1 < count ? splits[i] : L->size;
+        pieces[i].context = *L->context;
+        pieces[i].context.error = hold_error;
+        pieces[i].context.error_data = &pieces[i];
+    }
+    free(splits);
+
+    struct parallel work = {L, pieces, null, null, 0, 0, PTHREAD_MUTEX_INITIALIZER};
+    run_on_threads(&work, threads, parse_piece, count);
+
+    // A piece can be kept if every piece before it closed, and it closed too
+    // or ran to the end of the input.
+    size_t kept = 0;
+    while (kept < count && (kept == count - 1 || pieces[kept].closed)) {
+        kept++;
+    }
+    for (size_t i = kept; i < count; i++) {
+        stylesheet_free(pieces[i].ss);
+    }
+    for (size_t i = 0; i < kept; i++) {
+        pieces[i].atoms = atoms_merge(&L->atoms, &pieces[i].lexer->atoms);
+    }
+
+    // The kept pieces are renumbered and copied into the first, all at once.
+    if (kept) {
+        struct stylesheet* result = work.result = pieces[0].ss;
+        size_t rules = result->rule_count, values = result->value_count;
+        for (size_t i = 1; i < kept; i++) {
+            pieces[i].rule_base = rules;
+            pieces[i].value_base = values;
+            rules += pieces[i].ss->rule_count;
+            values += pieces[i].ss->value_count;
+        }
+        stylesheet_reserve(result, rules - result->rule_count, values - result->value_count);
+        run_on_threads(&work, threads, copy_piece, kept);
+        result->rule_count = rules;
+        result->value_count = values;
+    }
+    pthread_mutex_destroy(&work.lock);
 
-    for (struct component_value* cv = rule->prelude; cv; cv = cv->next) {
-        ss_print_component_value(cv, file);
-        fflush(file);
+    for (size_t i = 0; i < kept; i++) {
+        for (size_t j = 0; j < pieces[i].error_count; j++) {
+            struct held_error* e = &pieces[i].errors[j];
+            report_error(L->context, e->reason, e->line, e->column);
+        }
+        if (i > 0) {
+            stylesheet_adopt(work.result, pieces[i].ss);
+        }
     }
 
-    if (rule->block) {
-        assert(rule->block->type == CV_BLOCK);
-        ss_print_block(rule->block->data.block.end, rule->block->data.block.head, file);
+    // From the first piece that was not kept, the rest is parsed in one go.
+    if (kept < count) {
+        struct stylesheet* rest;
+        size_t rule_end;
+        struct lexer* lexer = parse_range(L, L->context, pieces[kept].begin, L->size, &rest,
+                                          &rule_end);
+        unsigned* atoms = atoms_merge(&L->atoms, &lexer->atoms);
+        if (atoms) {
+            stylesheet_renumber(rest, atoms);
+            free(atoms);
+        }
+        lexer_free(lexer);
+        if (work.result) {
+            stylesheet_reserve(work.result, rest->rule_count, rest->value_count);
+            stylesheet_copy(work.result, rest, work.result->rule_count, work.result->value_count);
+            work.result->rule_count += rest->rule_count;
+            work.result->value_count += rest->value_count;
+            stylesheet_adopt(work.result, rest);
+        } else {
+            work.result = rest;
+        }
     }
-    fputs("\n", file);
 
+    for (size_t i = 0; i < count; i++) {
+        lexer_free(pieces[i].lexer);
+        free(pieces[i].atoms);
+        free(pieces[i].errors);
+    }
+    free(pieces);
+    return work.result;
 }
 
-void stylesheet_print(struct stylesheet* ss, FILE* file) {
-    for (struct rule* rule = ss->rule; rule; rule = rule->next) {
-        ss_print_rule(rule, file);
+// Output
+
+// Printing goes through a user-space buffer that is handed to the file or
+// descriptor in large writes. Memory outputs just grow the buffer.
+enum { OUTPUT_BUFFER_SIZE = 64 * 1024 };
+
+enum output_kind {
+    OUTPUT_FILE,
+    OUTPUT_FD,
+    OUTPUT_MEMORY
+};
+
+struct output {
+    enum output_kind kind;
+    FILE* file;
+    int fd;
+    unsigned char* data;
+    size_t size;
+    size_t capacity;
+    bool failed; // a write to the file or descriptor failed
+};
+
+static struct output* output_new(enum output_kind kind) {
+    struct output* out = zmalloc(sizeof(struct output));
+    out->kind     = kind;
+    out->capacity = OUTPUT_BUFFER_SIZE;
+    out->data     = zmalloc(out->capacity);
+    return out;
+}
+
+struct output* output_file(FILE* file) {
+    struct output* out = output_new(OUTPUT_FILE);
+    out->file = file;
+    return out;
+}
+
+struct output* output_fd(int fd) {
+    struct output* out = output_new(OUTPUT_FD);
+    out->fd = fd;
+    return out;
+}
+
+struct output* output_memory(void) {
+    return output_new(OUTPUT_MEMORY);
+}
+
+// Hand `size` bytes straight to the file or descriptor.
+static void output_sink(struct output* out, const unsigned char* data, size_t size) {
+    if (out->kind == OUTPUT_FILE) {
+        if (fwrite(data, 1, size, out->file) != size) {
+            out->failed = true;
+        }
+        return;
+    }
+
+    while (size > 0) {
+        ssize_t written = write(out->fd, data, size);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            out->failed = true;
+            return;
+        }
+        data += written;
+        size -= written;
+    }
+}
+
+int output_flush(struct output* out) {
+    if (out->kind != OUTPUT_MEMORY) {
+        output_sink(out, out->data, out->size);
+        out->size = 0;
+        if (out->kind == OUTPUT_FILE && fflush(out->file) != 0) {
+            out->failed = true;
+        }
+    }
+    return out->failed ? EOF : 0;
+}
+
+void output_write(struct output* out, const void* data, size_t size) {
+    if (out->capacity - out->size < size) {
+        if (out->kind == OUTPUT_MEMORY) {
+            while (out->capacity - out->size < size) {
+                out->capacity *= 2;
+            }
+            unsigned char* grown = realloc(out->data, out->capacity);
+            if (!grown) {
+                fprintf(stderr, "Error allocating memory");
+                exit(EXIT_FAILURE);
+            }
+            out->data = grown;
+        } else {
+            output_sink(out, out->data, out->size);
+            out->size = 0;
+            // Too big to be worth buffering.
+            if (size >= out->capacity) {
+                output_sink(out, data, size);
+                return;
+            }
+        }
+    }
+    memcpy(out->data + out->size, data, size);
+    out->size += size;
+}
+
+const char* output_data(struct output* out, size_t* size) {
+    assert(out->kind == OUTPUT_MEMORY);
+    *size = out->size;
+    return (const char*)out->data;
+}
+
+void output_free(struct output* out) {
+    output_flush(out);
+    free(out->data);
+    free(out);
+}
+
+static void output_byte(struct output* out, unsigned char c) {
+    if (out->size == out->capacity) {
+        output_write(out, &c, 1);
+        return;
+    }
+    out->data[out->size++] = c;
+}
+
+static void output_string(struct output* out, const char* s) {
+    output_write(out, s, strlen(s));
+}
+
+static void output_cp(struct output* out, cp c) {
+    unsigned char bytes[4];
+    output_write(out, bytes, utf8_encode(c, bytes));
+}
+
+// Token text is mostly spans of the input, so printing needs the input too.
+// Minified output also remembers the last thing written, to decide whether the
+// next token can follow it without whitespace.
+struct printer {
+    struct output* out;
+    const unsigned char* source;
+    struct component_value* values;
+    bool minify;
+    bool selector;         // printing a qualified rule's prelude
+    bool lengths;          // a zero length can be written as a plain 0
+    bool verbatim;         // in a custom property's value, blocks included
+    enum token_type last;  // TOKEN_EOF before anything is written
+    cp last_delim;
+    bool range;            // the last two tokens were u and +, as in U+0-7F
+};
+
+static const unsigned char* ss_text(struct printer* out, struct text* text, size_t* size) {
+    return text_data(out->source, text, size);
+}
+
+static void ss_print_text(struct printer* out, struct text* text) {
+    size_t size;
+    const unsigned char* data = ss_text(out, text, &size);
+    output_write(out->out, data, size);
+}
+
+// Write c as a hex escape. The space ending it is only needed when the
+// character after it would otherwise be read as part of the escape.
+static void ss_print_hex_escape(struct output* file, cp c, cp following) {
+    char escape[12];
+    int length = snprintf(escape, sizeof(escape), "\\%x", (unsigned)c);
+    output_write(file, escape, length);
+    if (following == CHAR_EOF || char_hex(following) || whitespace(following)) {
+        output_byte(file, ' ');
+    }
+}
+
+enum name_kind {
+    NAME_IDENT,
+    NAME_HASH, // may start with a digit
+    NAME_UNIT  // follows a number, so must not read as its exponent
+};
+
+// The unit of 1\65 3 is e3, which written out as is would give 1e3.
+static bool unit_exponent(const unsigned char* data, size_t size) {
+    if (size < 2 || !is_exp(data[0])) return false;
+    if (char_digit(data[1])) return true;
+    return size > 2 && is_sign(data[1]) && char_digit(data[2]);
+}
+
+// Identifiers and hash names come back from the lexer with their escapes
+// decoded, so they must be escaped again on the way out. Text that is still a
+// span of the input had no escapes and is written as it was.
+static void ss_print_name(struct printer* out, struct text* text, enum name_kind kind) {
+    if (!text->decoded) {
+        ss_print_text(out, text);
+        return;
+    }
+
+    size_t size;
+    const unsigned char* data = ss_text(out, text, &size);
+    bool ident = kind != NAME_HASH;
+    cp first = CHAR_EOF;
+
+    for (size_t i = 0, index = 0; i < size; index++) {
+        size_t length;
+        cp c = utf8_decode(data + i, size - i, &length);
+        i += length;
+        cp following = i < size ? data[i] : CHAR_EOF;
+
+        if (index == 0) first = c;
+
+        if ((c >= 0x1 && c <= 0x1F) || c == 0x7F) {
+            ss_print_hex_escape(out->out, c, following);
+        } else if (kind == NAME_UNIT && index == 0 && unit_exponent(data, size)) {
+            ss_print_hex_escape(out->out, c, following);
+        } else if (ident && char_digit(c) && (index == 0 || (index == 1 && first == CHAR_HYPHEN_MINUS))) {
+            // An identifier cannot start with a digit, or a hyphen and a digit.
+            ss_print_hex_escape(out->out, c, following);
+        } else if (ident && index == 0 && c == CHAR_HYPHEN_MINUS && size == 1) {
+            output_string(out->out, "\\-");
+        } else if (char_name(c)) {
+            output_cp(out->out, c);
+        } else {
+            output_byte(out->out, CHAR_REVERSE_SOLIDUS);
+            output_cp(out->out, c);
+        }
     }
 }
+
+// Strings are written with whichever quote needs fewer escapes. A bad string
+// stays bad: it is left open, and the newline that ended it ends it again.
+static void ss_print_string(struct printer* out, struct text* text, bool bad) {
+    size_t size;
+    const unsigned char* data = ss_text(out, text, &size);
+
+    size_t doubles = 0, singles = 0;
+    for (size_t i = 0; i < size; i++) {
+        doubles += data[i] == CHAR_QUOTATION_MARK;
+        singles += data[i] == CHAR_APOSTROPHE;
+    }
+    cp quote = doubles <= singles ? CHAR_QUOTATION_MARK : CHAR_APOSTROPHE;
+
+    output_byte(out->out, quote);
+    for (size_t i = 0; i < size;) {
+        size_t length;
+        cp c = utf8_decode(data + i, size - i, &length);
+        i += length;
+        cp following = i < size ? data[i] : bad ? CHAR_LINE_FEED : quote;
+
+        if ((c >= 0x1 && c <= 0x1F) || c == 0x7F) {
+            ss_print_hex_escape(out->out, c, following);
+        } else if (c == quote || c == CHAR_REVERSE_SOLIDUS) {
+            output_byte(out->out, CHAR_REVERSE_SOLIDUS);
+            output_byte(out->out, c);
+        } else {
+            output_cp(out->out, c);
+        }
+    }
+    output_byte(out->out, bad ? CHAR_LINE_FEED : quote);
+}
+
+// 4.3.6. Consume a url token: an unquoted url cannot hold whitespace, quotes,
+// parentheses, backslashes or non-printable characters without escaping them.
+static bool url_unquoted(const unsigned char* data, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        unsigned char c = data[i];
+        if (c <= 0x20 || c == 0x7F || c == CHAR_QUOTATION_MARK || c == CHAR_APOSTROPHE ||
+            c == CHAR_LEFT_PARENTHESIS || c == CHAR_RIGHT_PARENTHESIS || c == CHAR_REVERSE_SOLIDUS) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void ss_print_url(struct printer* out, struct text* text) {
+    output_string(out->out, "url(");
+    size_t size;
+    const unsigned char* data = ss_text(out, text, &size);
+    if (out->minify && url_unquoted(data, size)) {
+        output_write(out->out, data, size);
+    } else {
+        ss_print_string(out, text, false);
+    }
+    output_byte(out->out, ')');
+}
+
+// 9. Serialization
+// Pairs of tokens that would be read back as something else if written next to
+// each other. `a` is the last token written, `b` the one about to follow it.
+static bool needs_separator(enum token_type a, cp a_delim, enum token_type b, cp b_delim) {
+    bool word    = b == TOKEN_IDENT || b == TOKEN_FUNCTION || b == TOKEN_URL ||
+                   b == TOKEN_BAD_URL || b == TOKEN_UNICODE_RANGE;
+    bool numeric = b == TOKEN_NUMBER || b == TOKEN_PERCENTAGE || b == TOKEN_DIMENSION;
+    bool minus   = b == TOKEN_DELIM && b_delim == CHAR_HYPHEN_MINUS;
+    bool cdc     = b == TOKEN_CDC;
+
+    switch (a) {
+        case TOKEN_IDENT:
+            // A lone u has its letter as `a_delim`.
+            return word || minus || numeric || cdc || b == TOKEN_PAREN_LEFT ||
+                   (a_delim == CHAR_LATIN_SMALL_U && b == TOKEN_DELIM && b_delim == CHAR_PLUS_SIGN);
+
+        case TOKEN_AT_KEYWORD:
+        case TOKEN_HASH:
+        case TOKEN_DIMENSION:
+        case TOKEN_UNICODE_RANGE:
+            return word || minus || numeric || cdc ||
+                   (a == TOKEN_UNICODE_RANGE && b == TOKEN_DELIM && b_delim == CHAR_QUESTION_MARK);
+
+        case TOKEN_NUMBER:
+            return word || minus || numeric || cdc ||
+                   (b == TOKEN_DELIM && b_delim == CHAR_PERCENT_SIGN);
+
+        case TOKEN_DELIM:
+            switch (a_delim) {
+                case CHAR_NUMBER_SIGN:
+                case CHAR_HYPHEN_MINUS:
+                    return word || minus || numeric || cdc;
+                case CHAR_COMMERCIAL_AT:
+                    return word || minus || cdc;
+                case CHAR_FULL_STOP:
+                case CHAR_PLUS_SIGN:
+                    return numeric;
+                case CHAR_SOLIDUS:
+                    return (b == TOKEN_DELIM && b_delim == CHAR_ASTERISK) ||
+                           b == TOKEN_SUBSTRING_MATCH;
+                case CHAR_LESS_THAN:
+                    return b == TOKEN_DELIM && b_delim == CHAR_EXCLAMATION_MARK;
+                case CHAR_DOLLAR_SIGN:
+                case CHAR_ASTERISK:
+                case CHAR_CIRCUMFLEX_ACCENT:
+                case CHAR_TILDE:
+                    return b == TOKEN_DELIM && b_delim == CHAR_EQUALS_SIGN;
+                case CHAR_VERTICAL_LINE:
+                    return (b == TOKEN_DELIM && (b_delim == CHAR_EQUALS_SIGN ||
+                                                 b_delim == CHAR_VERTICAL_LINE)) ||
+                           b == TOKEN_DASH_MATCH || b == TOKEN_COLUMN;
+                case CHAR_REVERSE_SOLIDUS:
+                    return true;
+                default:
+                    return false;
+            }
+
+        default:
+            return false;
+    }
+}
+
+static bool combinator(enum token_type type, cp delim) {
+    return type == TOKEN_DELIM &&
+           (delim == CHAR_GREATER_THAN || delim == CHAR_PLUS_SIGN || delim == CHAR_TILDE);
+}
+
+static bool attribute_matcher(enum token_type type, cp delim) {
+    switch (type) {
+        case TOKEN_INCLUDE_MATCH:
+        case TOKEN_DASH_MATCH:
+        case TOKEN_PREFIX_MATCH:
+        case TOKEN_SUFFIX_MATCH:
+        case TOKEN_SUBSTRING_MATCH:
+            return true;
+        case TOKEN_DELIM:
+            return delim == CHAR_EQUALS_SIGN;
+        default:
+            return false;
+    }
+}
+
+// Whether whitespace the source had before the next token changes its meaning.
+// Next to punctuation it never does; around combinators and attribute matchers
+// it does not in selectors, but elsewhere in a selector it is itself the
+// descendant combinator.
+static bool space_matters(struct printer* out, enum token_type next, cp next_delim) {
+    switch (out->last) {
+        case TOKEN_EOF:
+        case TOKEN_COLON:
+        case TOKEN_SEMICOLON:
+        case TOKEN_COMMA:
+        case TOKEN_LEFT_SQUARE:
+        case TOKEN_PAREN_LEFT:
+        case TOKEN_LEFT_CURLY:
+        case TOKEN_RIGHT_CURLY:
+            return false;
+        case TOKEN_DELIM:
+            if (out->last_delim == CHAR_EXCLAMATION_MARK) return false;
+            break;
+        default:
+            break;
+    }
+
+    switch (next) {
+        case TOKEN_SEMICOLON:
+        case TOKEN_COMMA:
+        case TOKEN_RIGHT_SQUARE:
+        case TOKEN_PAREN_RIGHT:
+        case TOKEN_LEFT_CURLY:
+        case TOKEN_RIGHT_CURLY:
+            return false;
+        case TOKEN_COLON:
+            return out->selector;
+        case TOKEN_DELIM:
+            if (next_delim == CHAR_EXCLAMATION_MARK) return false;
+            break;
+        default:
+            break;
+    }
+
+    if (out->selector) {
+        return !combinator(out->last, out->last_delim) && !combinator(next, next_delim) &&
+               !attribute_matcher(out->last, out->last_delim) && !attribute_matcher(next, next_delim);
+    }
+    return true;
+}
+
+// Called before writing anything that starts with a token of `type`, and
+// writes the whitespace minified output can not do without.
+static void ss_separate(struct printer* out, enum token_type type, cp delim, bool space_before) {
+    if (!out->minify) return;
+
+    // u+ is read back as the start of a unicode-range when a hex digit or a
+    // question mark follows it.
+    bool range = out->range && (type == TOKEN_IDENT || type == TOKEN_FUNCTION ||
+                                type == TOKEN_NUMBER || type == TOKEN_PERCENTAGE ||
+                                type == TOKEN_DIMENSION ||
+                                (type == TOKEN_DELIM && delim == CHAR_QUESTION_MARK));
+
+    if (range || needs_separator(out->last, out->last_delim, type, delim) ||
+        (space_before && space_matters(out, type, delim))) {
+        // A lone backslash is only a delimiter because a newline follows it.
+        bool newline = out->last == TOKEN_DELIM && out->last_delim == CHAR_REVERSE_SOLIDUS;
+        output_byte(out->out, newline ? CHAR_LINE_FEED : CHAR_SPACE);
+    }
+}
+
+static void ss_written(struct printer* out, enum token_type type, cp delim) {
+    out->range = out->last == TOKEN_IDENT && out->last_delim == CHAR_LATIN_SMALL_U &&
+                 type == TOKEN_DELIM && delim == CHAR_PLUS_SIGN;
+    out->last = type;
+    out->last_delim = delim;
+}
+
+// ASCII case-insensitive comparison of text with a keyword.
+static bool text_is(const unsigned char* data, size_t size, const char* keyword) {
+    for (size_t i = 0; i < size; i++) {
+        if (keyword[i] == '\0' || char_lower(data[i]) != keyword[i]) return false;
+    }
+    return keyword[size] == '\0';
+}
+
+// Where a unitless zero means something other than a zero length.
+static bool zero_lengths_allowed(struct printer* out, struct token* property) {
+    return !custom_property(out->source, property) && property->atom != ATOM_FLEX &&
+           property->atom != ATOM_MS_FLEX && property->atom != ATOM_WEBKIT_FLEX;
+}
+
+// The significant digits and decimal exponent of the shortest text strtod
+// reads back as the positive `value`: 0.015 is "15" with exponent -2.
+static int shortest_digits(double value, char digits[17], int* exponent) {
+    char text[32];
+    for (int precision = 1; precision <= 17; precision++) {
+        snprintf(text, sizeof(text), "%.*e", precision - 1, value);
+        if (strtod(text, null) == value) break;
+    }
+
+    int n = 0;
+    const char* c = text;
+    for (; *c != 'e'; c++) {
+        if (char_digit(*c)) digits[n++] = *c;
+    }
+    *exponent = atoi(c + 1);
+
+    while (n > 1 && digits[n - 1] == '0') n--;
+    return n;
+}
+
+static void output_zeros(struct output* file, int count) {
+    while (count-- > 0) output_byte(file, '0');
+}
+
+// Write `value` in as few characters as read back to the same double, either
+// positional (.5, 1500) or with an exponent (15e-7). A `number` keeps its
+// number type, so an integral value gets a fraction or an exponent.
+static void ss_print_decimal(struct output* file, double value, bool number) {
+    if (signbit(value)) {
+        output_byte(file, CHAR_HYPHEN_MINUS);
+        value = -value;
+    }
+
+    if (value == 0) {
+        output_string(file, number ? ".0" : "0");
+        return;
+    }
+
+    char digits[17];
+    int exponent;
+    int n = shortest_digits(value, digits, &exponent);
+
+    char power[8];
+    int power_length = snprintf(power, sizeof(power), "e%d", exponent - (n - 1));
+
+    int positional;
+    if (exponent >= n - 1) {
+        positional = exponent + 1 + (number ? 2 : 0);
+    } else if (exponent >= 0) {
+        positional = n + 1;
+    } else {
+        positional = n + 1 + (-exponent - 1);
+    }
+
+    if (n + power_length < positional) {
+        output_write(file, digits, n);
+        output_write(file, power, power_length);
+    } else if (exponent >= n - 1) {
+        output_write(file, digits, n);
+        output_zeros(file, exponent - (n - 1));
+        if (number) output_string(file, ".0");
+    } else if (exponent >= 0) {
+        output_write(file, digits, exponent + 1);
+        output_byte(file, CHAR_FULL_STOP);
+        output_write(file, digits + exponent + 1, n - (exponent + 1));
+    } else {
+        output_byte(file, CHAR_FULL_STOP);
+        output_zeros(file, -exponent - 1);
+        output_write(file, digits, n);
+    }
+}
+
+// Integers keep their digits, which a double may not hold exactly, less a
+// plus sign and leading zeros.
+static void ss_print_integer(struct printer* out, struct text* text) {
+    size_t size;
+    const unsigned char* data = ss_text(out, text, &size);
+    size_t i = 0;
+
+    if (data[0] == CHAR_HYPHEN_MINUS) {
+        output_byte(out->out, CHAR_HYPHEN_MINUS);
+        i++;
+    } else if (data[0] == CHAR_PLUS_SIGN) {
+        i++;
+    }
+    while (i + 1 < size && data[i] == '0') i++;
+    output_write(out->out, data + i, size - i);
+}
+
+static void ss_print_numeric(struct printer* out, struct token* token) {
+    struct text* unit = &token->value.number.unit;
+
+    if (!out->minify) {
+        ss_print_text(out, &token->text);
+    } else if (token->type == TOKEN_NUMBER && token->value.number.integer) {
+        ss_print_integer(out, &token->text);
+    } else if (token->type == TOKEN_DIMENSION && out->lengths && number_value(token) == 0 &&
+               atom_is(token->atom, KEYWORD_LENGTH)) {
+        ss_print_decimal(out->out, number_value(token), false);
+        return;
+    } else {
+        // Only plain numbers have grammar that asks for integers.
+        ss_print_decimal(out->out, number_value(token), token->type == TOKEN_NUMBER);
+    }
+
+    if (token->type == TOKEN_PERCENTAGE) {
+        output_byte(out->out, CHAR_PERCENT_SIGN);
+    } else if (token->type == TOKEN_DIMENSION) {
+        ss_print_name(out, unit, NAME_UNIT);
+    }
+}
+
+static void ss_print_component_value(struct component_value* cv, struct printer* out);
+
+static void ss_print_token(struct token* token, bool space_before, struct printer* out) {
+    struct output* file = out->out;
+    cp delim = token->type == TOKEN_DELIM ? token->value.delim.value : 0;
+
+    ss_separate(out, token->type, delim, space_before);
+
+    switch (token->type) {
+        case TOKEN_COLON:
+        case TOKEN_SEMICOLON:
+        case TOKEN_COMMA:
+        case TOKEN_LEFT_SQUARE:
+        case TOKEN_RIGHT_SQUARE:
+        case TOKEN_PAREN_LEFT:
+        case TOKEN_PAREN_RIGHT:
+        case TOKEN_LEFT_CURLY:
+        case TOKEN_RIGHT_CURLY:
+            output_byte(file, token->type);
+            break;
+
+        case TOKEN_IDENT:
+            ss_print_name(out, &token->text, NAME_IDENT);
+            break;
+
+        case TOKEN_NUMBER:
+        case TOKEN_PERCENTAGE:
+        case TOKEN_DIMENSION:
+            ss_print_numeric(out, token);
+            break;
+
+        case TOKEN_HASH:
+            // An id selector's name has to read back as an identifier.
+            output_byte(file, CHAR_NUMBER_SIGN);
+            ss_print_name(out, &token->text, token->value.hash.id ? NAME_IDENT : NAME_HASH);
+            break;
+
+        case TOKEN_AT_KEYWORD:
+            output_byte(file, CHAR_COMMERCIAL_AT);
+            ss_print_name(out, &token->text, NAME_IDENT);
+            break;
+
+        case TOKEN_DELIM:
+            output_cp(file, delim);
+            break;
+
+        case TOKEN_URL:
+            ss_print_url(out, &token->text);
+            break;
+
+        case TOKEN_STRING:
+        case TOKEN_BAD_STRING:
+            ss_print_string(out, &token->text, token->type == TOKEN_BAD_STRING);
+            break;
+
+        case TOKEN_BAD_URL:
+            // A parenthesis is not allowed in an unquoted url.
+            output_string(file, "url(()");
+            break;
+
+        case TOKEN_UNICODE_RANGE: {
+            char range[32];
+            int start = token->value.range.start, end = token->value.range.end;
+            int length = start == end
+                ? snprintf(range, sizeof(range), "U+%X", start)
+                : snprintf(range, sizeof(range), "U+%X-%X", start, end);
+            output_write(file, range, length);
+            break;
+        }
+
+        case TOKEN_INCLUDE_MATCH:   output_string(file, "~=");   break;
+        case TOKEN_DASH_MATCH:      output_string(file, "|=");   break;
+        case TOKEN_PREFIX_MATCH:    output_string(file, "^=");   break;
+        case TOKEN_SUFFIX_MATCH:    output_string(file, "$=");   break;
+        case TOKEN_SUBSTRING_MATCH: output_string(file, "*=");   break;
+        case TOKEN_COLUMN:          output_string(file, "||");   break;
+        case TOKEN_CDO:             output_string(file, "<!--"); break;
+        case TOKEN_CDC:             output_string(file, "-->");  break;
+
+        case TOKEN_COMMENT: {
+            // Written as it was, closed if the input ended inside it.
+            size_t size;
+            const unsigned char* data = text_data(out->source, &token->text, &size);
+            output_write(file, data, size);
+            if (size < 5 || data[size - 2] != CHAR_ASTERISK || data[size - 1] != CHAR_SOLIDUS) {
+                output_string(file, "*/");
+            }
+            break;
+        }
+
+        case TOKEN_EOF:
+            break;
+
+        default:
+            assert(0);
+    }
+
+    // An identifier that is just a u is remembered by its letter.
+    if (token->type == TOKEN_IDENT) {
+        size_t size;
+        const unsigned char* data = ss_text(out, &token->text, &size);
+        if (size == 1 && char_lower(data[0]) == CHAR_LATIN_SMALL_U) delim = CHAR_LATIN_SMALL_U;
+    }
+
+    ss_written(out, token->type, delim);
+    if (!out->minify) {
+        output_byte(file, CHAR_SPACE);
+    }
+}
+
+static void ss_print_block(cp end, struct children children, bool space_before, struct printer* out) {
+    enum token_type start = mirror_of(end);
+    bool lengths = out->lengths;
+    bool selector = out->selector;
+    bool verbatim = out->verbatim;
+
+    ss_separate(out, start, 0, space_before);
+    output_byte(out->out, start);
+    ss_written(out, start, 0);
+
+    struct declaration declaration = {null, false, false};
+    struct component_value* first = out->values + children.first;
+    struct component_value* last = first + children.count;
+    bool statement = true;
+
+    for (struct component_value* i = first; i < last; i++) {
+        if (end == TOKEN_RIGHT_CURLY && !verbatim) {
+            declaration_next(&declaration, out->source, i);
+
+            // A {} block can hold rules as well as declarations, and the
+            // prelude of a nested rule is a selector.
+            if (statement) out->selector = nested_rule(out->source, i, last);
+            statement = cv_is(i, TOKEN_SEMICOLON) ||
+                        (i->type == CV_BLOCK && i->data.block.end == TOKEN_RIGHT_CURLY &&
+                         !(declaration.value && declaration.custom));
+            if (statement) out->selector = false;
+        }
+        out->verbatim = verbatim || (declaration.value && declaration.custom);
+        out->lengths = declaration.value && !out->selector && !out->verbatim &&
+                       zero_lengths_allowed(out, declaration.property);
+
+        // Empty declarations, and the semicolon ending the last one, are
+        // not needed.
+        if (out->minify && end == TOKEN_RIGHT_CURLY && !verbatim && cv_is(i, TOKEN_SEMICOLON) &&
+            (i + 1 == last || cv_is(i + 1, TOKEN_SEMICOLON) ||
+             out->last == TOKEN_LEFT_CURLY)) {
+            continue;
+        }
+        ss_print_component_value(i, out);
+    }
+    out->lengths = lengths;
+    out->selector = selector;
+    out->verbatim = verbatim;
+
+    ss_separate(out, end, 0, false);
+    output_byte(out->out, end);
+    ss_written(out, end, 0);
+    if (!out->minify) {
+        output_byte(out->out, CHAR_LINE_FEED);
+    }
+}
+
+static void ss_print_function(struct token* name, struct children children, bool space_before,
+                              struct printer* out) {
+    bool lengths = out->lengths;
+
+    ss_separate(out, TOKEN_FUNCTION, 0, space_before);
+    ss_print_name(out, &name->text, NAME_IDENT);
+    output_byte(out->out, '(');
+    ss_written(out, TOKEN_PAREN_LEFT, 0);
+
+    // Inside calc() and friends a zero needs its unit.
+    out->lengths = false;
+    for (size_t i = 0; i < children.count; i++) {
+        ss_print_component_value(&out->values[children.first + i], out);
+    }
+    out->lengths = lengths;
+
+    ss_separate(out, TOKEN_PAREN_RIGHT, 0, false);
+    output_byte(out->out, ')');
+    ss_written(out, TOKEN_PAREN_RIGHT, 0);
+}
+
+static void ss_print_component_value(struct component_value* cv, struct printer* out) {
+    switch (cv->type) {
+        case CV_TOKEN:
+            ss_print_token(cv->data.token, cv->space_before, out);
+            break;
+        case CV_BLOCK:
+            ss_print_block(cv->data.block.end, cv->children, cv->space_before, out);
+            break;
+        case CV_FUNCTION:
+            ss_print_function(cv->data.function.name, cv->children, cv->space_before, out);
+            break;
+    }
+}
+
+static void ss_print_rule(struct rule* rule, struct printer* out) {
+
+    if (rule->type == RULE_AT) {
+        assert(rule->at_name);
+        ss_print_token(rule->at_name, false, out);
+    }
+
+    out->selector = rule->type == RULE_QUALIFIED;
+    for (size_t i = 0; i < rule->prelude.count; i++) {
+        ss_print_component_value(&out->values[rule->prelude.first + i], out);
+    }
+    out->selector = false;
+
+    if (rule->has_block) {
+        ss_print_block(TOKEN_RIGHT_CURLY, rule->block, false, out);
+    } else if (rule->type == RULE_AT) {
+        ss_separate(out, TOKEN_SEMICOLON, 0, false);
+        output_byte(out->out, ';');
+        ss_written(out, TOKEN_SEMICOLON, 0);
+    }
+
+    if (!out->minify) {
+        output_byte(out->out, CHAR_LINE_FEED);
+    }
+}
+
+static void ss_write(struct stylesheet* ss, struct output* output, bool minify) {
+    struct printer out = {output, ss->source, ss->values, minify, false, false, false, TOKEN_EOF, 0,
+                          false};
+    for (size_t i = 0; i < ss->rule_count; i++) {
+        ss_print_rule(&ss->rules[i], &out);
+    }
+}
+
+void stylesheet_write(struct stylesheet* ss, struct output* output) {
+    ss_write(ss, output, false);
+}
+
+void stylesheet_write_minified(struct stylesheet* ss, struct output* output) {
+    ss_write(ss, output, true);
+}
+
+void stylesheet_print(struct stylesheet* ss, FILE* file) {
+    struct output* out = output_file(file);
+    stylesheet_write(ss, out);
+    output_free(out);
+}
+
+// Optimization
+// A pass over the parsed stylesheet that rewrites values to shorter forms
+// meaning the same thing, before it is written out.
+
+// 6.1. Named Colors, sorted by name.
+struct named_color {
+    const char* name; // first, so an entry can be searched as a keyword
+    unsigned rgb;
+};
+
+static const struct named_color named_colors[] = {
+    {"aliceblue", 0xf0f8ff},
+    {"antiquewhite", 0xfaebd7},
+    {"aqua", 0x00ffff},
+    {"aquamarine", 0x7fffd4},
+    {"azure", 0xf0ffff},
+    {"beige", 0xf5f5dc},
+    {"bisque", 0xffe4c4},
+    {"black", 0x000000},
+    {"blanchedalmond", 0xffebcd},
+    {"blue", 0x0000ff},
+    {"blueviolet", 0x8a2be2},
+    {"brown", 0xa52a2a},
+    {"burlywood", 0xdeb887},
+    {"cadetblue", 0x5f9ea0},
+    {"chartreuse", 0x7fff00},
+    {"chocolate", 0xd2691e},
+    {"coral", 0xff7f50},
+    {"cornflowerblue", 0x6495ed},
+    {"cornsilk", 0xfff8dc},
+    {"crimson", 0xdc143c},
+    {"cyan", 0x00ffff},
+    {"darkblue", 0x00008b},
+    {"darkcyan", 0x008b8b},
+    {"darkgoldenrod", 0xb8860b},
+    {"darkgray", 0xa9a9a9},
+    {"darkgreen", 0x006400},
+    {"darkgrey", 0xa9a9a9},
+    {"darkkhaki", 0xbdb76b},
+    {"darkmagenta", 0x8b008b},
+    {"darkolivegreen", 0x556b2f},
+    {"darkorange", 0xff8c00},
+    {"darkorchid", 0x9932cc},
+    {"darkred", 0x8b0000},
+    {"darksalmon", 0xe9967a},
+    {"darkseagreen", 0x8fbc8f},
+    {"darkslateblue", 0x483d8b},
+    {"darkslategray", 0x2f4f4f},
+    {"darkslategrey", 0x2f4f4f},
+    {"darkturquoise", 0x00ced1},
+    {"darkviolet", 0x9400d3},
+    {"deeppink", 0xff1493},
+    {"deepskyblue", 0x00bfff},
+    {"dimgray", 0x696969},
+    {"dimgrey", 0x696969},
+    {"dodgerblue", 0x1e90ff},
+    {"firebrick", 0xb22222},
+    {"floralwhite", 0xfffaf0},
+    {"forestgreen", 0x228b22},
+    {"fuchsia", 0xff00ff},
+    {"gainsboro", 0xdcdcdc},
+    {"ghostwhite", 0xf8f8ff},
+    {"gold", 0xffd700},
+    {"goldenrod", 0xdaa520},
+    {"gray", 0x808080},
+    {"green", 0x008000},
+    {"greenyellow", 0xadff2f},
+    {"grey", 0x808080},
+    {"honeydew", 0xf0fff0},
+    {"hotpink", 0xff69b4},
+    {"indianred", 0xcd5c5c},
+    {"indigo", 0x4b0082},
+    {"ivory", 0xfffff0},
+    {"khaki", 0xf0e68c},
+    {"lavender", 0xe6e6fa},
+    {"lavenderblush", 0xfff0f5},
+    {"lawngreen", 0x7cfc00},
+    {"lemonchiffon", 0xfffacd},
+    {"lightblue", 0xadd8e6},
+    {"lightcoral", 0xf08080},
+    {"lightcyan", 0xe0ffff},
+    {"lightgoldenrodyellow", 0xfafad2},
+    {"lightgray", 0xd3d3d3},
+    {"lightgreen", 0x90ee90},
+    {"lightgrey", 0xd3d3d3},
+    {"lightpink", 0xffb6c1},
+    {"lightsalmon", 0xffa07a},
+    {"lightseagreen", 0x20b2aa},
+    {"lightskyblue", 0x87cefa},
+    {"lightslategray", 0x778899},
+    {"lightslategrey", 0x778899},
+    {"lightsteelblue", 0xb0c4de},
+    {"lightyellow", 0xffffe0},
+    {"lime", 0x00ff00},
+    {"limegreen", 0x32cd32},
+    {"linen", 0xfaf0e6},
+    {"magenta", 0xff00ff},
+    {"maroon", 0x800000},
+    {"mediumaquamarine", 0x66cdaa},
+    {"mediumblue", 0x0000cd},
+    {"mediumorchid", 0xba55d3},
+    {"mediumpurple", 0x9370db},
+    {"mediumseagreen", 0x3cb371},
+    {"mediumslateblue", 0x7b68ee},
+    {"mediumspringgreen", 0x00fa9a},
+    {"mediumturquoise", 0x48d1cc},
+    {"mediumvioletred", 0xc71585},
+    {"midnightblue", 0x191970},
+    {"mintcream", 0xf5fffa},
+    {"mistyrose", 0xffe4e1},
+    {"moccasin", 0xffe4b5},
+    {"navajowhite", 0xffdead},
+    {"navy", 0x000080},
+    {"oldlace", 0xfdf5e6},
+    {"olive", 0x808000},
+    {"olivedrab", 0x6b8e23},
+    {"orange", 0xffa500},
+    {"orangered", 0xff4500},
+    {"orchid", 0xda70d6},
+    {"palegoldenrod", 0xeee8aa},
+    {"palegreen", 0x98fb98},
+    {"paleturquoise", 0xafeeee},
+    {"palevioletred", 0xdb7093},
+    {"papayawhip", 0xffefd5},
+    {"peachpuff", 0xffdab9},
+    {"peru", 0xcd853f},
+    {"pink", 0xffc0cb},
+    {"plum", 0xdda0dd},
+    {"powderblue", 0xb0e0e6},
+    {"purple", 0x800080},
+    {"rebeccapurple", 0x663399},
+    {"red", 0xff0000},
+    {"rosybrown", 0xbc8f8f},
+    {"royalblue", 0x4169e1},
+    {"saddlebrown", 0x8b4513},
+    {"salmon", 0xfa8072},
+    {"sandybrown", 0xf4a460},
+    {"seagreen", 0x2e8b57},
+    {"seashell", 0xfff5ee},
+    {"sienna", 0xa0522d},
+    {"silver", 0xc0c0c0},
+    {"skyblue", 0x87ceeb},
+    {"slateblue", 0x6a5acd},
+    {"slategray", 0x708090},
+    {"slategrey", 0x708090},
+    {"snow", 0xfffafa},
+    {"springgreen", 0x00ff7f},
+    {"steelblue", 0x4682b4},
+    {"tan", 0xd2b48c},
+    {"teal", 0x008080},
+    {"thistle", 0xd8bfd8},
+    {"tomato", 0xff6347},
+    {"turquoise", 0x40e0d0},
+    {"violet", 0xee82ee},
+    {"wheat", 0xf5deb3},
+    {"white", 0xffffff},
+    {"whitesmoke", 0xf5f5f5},
+    {"yellow", 0xffff00},
+    {"yellowgreen", 0x9acd32},
+};
+
+// The names that are shorter than any hex form of their color, sorted by
+// color. Where two names share a color the first of them is kept.
+static const struct named_color short_names[] = {
+    {"navy", 0x000080},
+    {"green", 0x008000},
+    {"teal", 0x008080},
+    {"indigo", 0x4b0082},
+    {"maroon", 0x800000},
+    {"purple", 0x800080},
+    {"olive", 0x808000},
+    {"gray", 0x808080},
+    {"sienna", 0xa0522d},
+    {"brown", 0xa52a2a},
+    {"silver", 0xc0c0c0},
+    {"peru", 0xcd853f},
+    {"tan", 0xd2b48c},
+    {"orchid", 0xda70d6},
+    {"plum", 0xdda0dd},
+    {"violet", 0xee82ee},
+    {"khaki", 0xf0e68c},
+    {"azure", 0xf0ffff},
+    {"wheat", 0xf5deb3},
+    {"beige", 0xf5f5dc},
+    {"salmon", 0xfa8072},
+    {"linen", 0xfaf0e6},
+    {"red", 0xff0000},
+    {"tomato", 0xff6347},
+    {"coral", 0xff7f50},
+    {"orange", 0xffa500},
+    {"pink", 0xffc0cb},
+    {"gold", 0xffd700},
+    {"bisque", 0xffe4c4},
+    {"snow", 0xfffafa},
+    {"ivory", 0xfffff0},
+};
+
+struct keyword_key {
+    const unsigned char* data;
+    size_t size;
+};
+
+// Case-insensitive order of text against a table entry that starts with its
+// keyword.
+static int compare_keyword(const void* key, const void* entry) {
+    const struct keyword_key* k = key;
+    const char* keyword = *(const char* const*)entry;
+    for (size_t i = 0;; i++) {
+        int a = i < k->size ? char_lower(k->data[i]) : 0;
+        int b = (unsigned char)keyword[i];
+        if (a != b || b == 0) return a - b;
+    }
+}
+
+static const void* keyword_find(const unsigned char* data, size_t size,
+                                const void* table, size_t count, size_t width) {
+    struct keyword_key key = {data, size};
+    return bsearch(&key, table, count, width, compare_keyword);
+}
+
+static int compare_rgb(const void* key, const void* entry) {
+    unsigned rgb = *(const unsigned*)key;
+    unsigned other = ((const struct named_color*)entry)->rgb;
+    return rgb < other ? -1 : rgb > other;
+}
+
+struct optimizer {
+    struct arena* arena;
+    const unsigned char* source;
+    struct component_value* values;
+};
+
+static int hex_value(unsigned char c) {
+    if (char_digit(c)) return c - '0';
+    return char_lower(c) - 'a' + 10;
+}
+
+// #rgb, #rgba, #rrggbb or #rrggbbaa.
+static bool hash_color(const unsigned char* data, size_t size, unsigned* rgb, unsigned* alpha) {
+    if (size != 3 && size != 4 && size != 6 && size != 8) return false;
+    for (size_t i = 0; i < size; i++) {
+        if (!char_hex(data[i])) return false;
+    }
+
+    unsigned channels[4] = {0, 0, 0, 0xFF};
+    bool single = size <= 4;
+    for (size_t i = 0; i < size / (single ? 1 : 2); i++) {
+        channels[i] = single ? hex_value(data[i]) * 0x11
+                             : hex_value(data[2 * i]) * 0x10 + hex_value(data[2 * i + 1]);
+    }
+    *rgb   = channels[0] << 16 | channels[1] << 8 | channels[2];
+    *alpha = channels[3];
+    return true;
+}
+
+// The shortest text for a color: a name, or 3, 4, 6 or 8 hex digits, which
+// is returned without its #.
+static size_t color_encode(unsigned rgb, unsigned alpha, char text[9], enum token_type* type) {
+    if (alpha == 0xFF) {
+        const struct named_color* name = bsearch(&rgb, short_names, COUNT(short_names),
+                                                 sizeof(short_names[0]), compare_rgb);
+        if (name) {
+            *type = TOKEN_IDENT;
+            return strlen(strcpy(text, name->name));
+        }
+    }
+
+    static const char digits[] = "0123456789abcdef";
+    unsigned channels[4] = {rgb >> 16 & 0xFF, rgb >> 8 & 0xFF, rgb & 0xFF, alpha};
+    size_t count = alpha == 0xFF ? 3 : 4;
+    bool single = true;
+    for (size_t i = 0; i < count; i++) {
+        single &= channels[i] % 0x11 == 0;
+    }
+
+    size_t length = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (!single) text[length++] = digits[channels[i] >> 4];
+        text[length++] = digits[channels[i] & 0xF];
+    }
+    text[length] = '\0';
+    *type = TOKEN_HASH;
+    return length;
+}
+
+// A channel of 0 to 255 that hex can hold exactly, clamped as the color
+// functions do.
+static bool channel(double value, unsigned* result) {
+    if (value < 0) value = 0;
+    if (value > 255) value = 255;
+    double rounded = floor(value + 0.5);
+    if (fabs(value - rounded) > 1e-9) return false;
+    *result = rounded;
+    return true;
+}
+
+// 7.1. Converting HSL Colors to sRGB: one channel, from 0 to 1.
+static double hsl_channel(double n, double hue, double saturation, double lightness) {
+    double k = fmod(n + hue / 30, 12);
+    double a = saturation * fmin(lightness, 1 - lightness);
+    return lightness - a * fmax(-1, fmin(fmin(k - 3, 9 - k), 1));
+}
+
+// rgb(), rgba(), hsl() and hsla() whose arguments are all literals, in the
+// legacy form separated by commas or the modern form with a slash before the
+// alpha. Colors hex cannot hold exactly are left alone.
+static bool function_color(struct optimizer* o, struct component_value* function,
+                           unsigned* rgb, unsigned* alpha) {
+    unsigned name = function->data.function.name->atom;
+    bool hsl = name == ATOM_HSL || name == ATOM_HSLA;
+    if (!hsl && name != ATOM_RGB && name != ATOM_RGBA) {
+        return false;
+    }
+
+    struct token* args[4];
+    size_t count = 0, commas = 0;
+    bool slash = false, previous_arg = false;
+
+    for (size_t i = 0; i < function->children.count; i++) {
+        struct component_value* cv = &o->values[function->children.first + i];
+        if (cv->type != CV_TOKEN) return false;
+        struct token* t = cv->data.token;
+
+        switch (t->type) {
+            case TOKEN_NUMBER:
+            case TOKEN_PERCENTAGE:
+            case TOKEN_DIMENSION:
+                if (count == 4) return false;
+                args[count++] = t;
+                previous_arg = true;
+                break;
+            case TOKEN_COMMA:
+                if (!previous_arg) return false;
+                commas++;
+                previous_arg = false;
+                break;
+            case TOKEN_DELIM:
+                if (t->value.delim.value != CHAR_SOLIDUS || count != 3 || slash) return false;
+                slash = true;
+                previous_arg = false;
+                break;
+            default:
+                return false;
+        }
+    }
+
+    bool legacy = commas > 0;
+    if (count < 3 || !previous_arg) return false;
+    if (legacy ? (commas != count - 1 || slash) : (count == 4) != slash) return false;
+
+    double values[3];
+    for (size_t i = 0; i < 3; i++) {
+        struct token* t = args[i];
+        double value = number_value(t);
+
+        if (t->type == TOKEN_DIMENSION) {
+            // Only a hue in degrees.
+            if (!hsl || i != 0 || t->atom != ATOM_DEG) return false;
+        } else if (hsl) {
+            // The hue is a number, and the legacy form wants percentages
+            // after it.
+            if (i == 0 && t->type == TOKEN_PERCENTAGE) return false;
+            if (i > 0 && legacy && t->type != TOKEN_PERCENTAGE) return false;
+        } else {
+            // The legacy form does not mix numbers and percentages.
+            if (legacy && t->type != args[0]->type) return false;
+            if (t->type == TOKEN_PERCENTAGE) value = value * 255 / 100;
+        }
+        values[i] = value;
+    }
+
+    if (hsl) {
+        double hue = fmod(values[0], 360);
+        if (hue < 0) hue += 360;
+        double saturation = fmin(fmax(values[1], 0), 100) / 100;
+        double lightness  = fmin(fmax(values[2], 0), 100) / 100;
+        static const double n[3] = {0, 8, 4};
+        for (size_t i = 0; i < 3; i++) {
+            values[i] = hsl_channel(n[i], hue, saturation, lightness) * 255;
+        }
+    }
+
+    unsigned channels[3];
+    for (size_t i = 0; i < 3; i++) {
+        if (!channel(values[i], &channels[i])) return false;
+    }
+
+    *alpha = 0xFF;
+    if (count == 4) {
+        struct token* t = args[3];
+        if (t->type == TOKEN_DIMENSION) return false;
+        double value = number_value(t);
+        if (t->type == TOKEN_PERCENTAGE) value /= 100;
+        if (!channel(fmin(fmax(value, 0), 1) * 255, alpha)) return false;
+    }
+
+    *rgb = channels[0] << 16 | channels[1] << 8 | channels[2];
+    return true;
+}
+
+static void token_set_text(struct optimizer* o, struct token* t, enum token_type type,
+                           const char* text, size_t size) {
+    t->type = type;
+    t->atom = NO_ATOM;
+    text_init(&t->text);
+    buffer_append(o->arena, &t->text.buffer, (const unsigned char*)text, size);
+    t->text.decoded = true;
+    if (type == TOKEN_HASH) {
+        t->value.hash.id = !char_digit(text[0]);
+    }
+}
+
+// Rewrite a color token in place when its shortest form is shorter. Names
+// are only colors where the property says so.
+static void optimize_color_token(struct optimizer* o, struct token* t, bool names) {
+    size_t size;
+    const unsigned char* data = text_data(o->source, &t->text, &size);
+    unsigned rgb, alpha;
+
+    if (t->type == TOKEN_HASH) {
+        if (!hash_color(data, size, &rgb, &alpha)) return;
+        size++;
+    } else if (t->type == TOKEN_IDENT && names) {
+        const struct named_color* color = keyword_find(data, size, named_colors, COUNT(named_colors),
+                                                       sizeof(named_colors[0]));
+        if (!color) return;
+        rgb = color->rgb;
+        alpha = 0xFF;
+    } else {
+        return;
+    }
+
+    char text[9];
+    enum token_type type;
+    size_t length = color_encode(rgb, alpha, text, &type);
+    if (length + (type == TOKEN_HASH) <= size) {
+        token_set_text(o, t, type, text, length);
+    }
+}
+
+// Functions whose arguments are colors whatever the property. Others, like
+// the progid:...gradient() of old filters, may want theirs as written.
+static bool color_arguments(struct optimizer* o, struct token* function) {
+    unsigned atom = function->atom;
+    if (atom == ATOM_COLOR_MIX || atom == ATOM_DROP_SHADOW || atom == ATOM_LIGHT_DARK) {
+        return true;
+    }
+
+    static const char suffix[] = "-gradient";
+    size_t n = sizeof(suffix) - 1, size;
+    const unsigned char* name = text_data(o->source, &function->text, &size);
+    return size > n && text_is(name + size - n, n, suffix);
+}
+
+static void optimize_value(struct optimizer* o, struct component_value* cv, bool names) {
+    unsigned rgb, alpha;
+
+    switch (cv->type) {
+        case CV_TOKEN:
+            optimize_color_token(o, cv->data.token, names);
+            break;
+
+        case CV_FUNCTION:
+            if (function_color(o, cv, &rgb, &alpha)) {
+                struct token* t = arena_alloc(o->arena, sizeof(struct token));
+                t->pooled = true;
+
+                char text[9];
+                enum token_type type;
+                size_t size = color_encode(rgb, alpha, text, &type);
+                token_set_text(o, t, type, text, size);
+
+                cv->type = CV_TOKEN;
+                cv->data.token = t;
+            } else {
+                struct token* name = cv->data.function.name;
+                if (name->atom == ATOM_VAR || color_arguments(o, name)) {
+                    // The fallback of var() is a value of the property it is in.
+                    bool colors = name->atom == ATOM_VAR ? names : true;
+                    for (size_t i = 0; i < cv->children.count; i++) {
+                        optimize_value(o, &o->values[cv->children.first + i], colors);
+                    }
+                }
+            }
+            break;
+
+        case CV_BLOCK:
+            break;
+    }
+}
+
+static void optimize_block(struct optimizer* o, struct children children) {
+    struct declaration declaration = {null, false, false};
+    bool names = false;
+    bool statement = true, prelude = false;
+    struct component_value* last = o->values + children.first + children.count;
+
+    for (size_t i = 0; i < children.count; i++) {
+        struct component_value* cv = &o->values[children.first + i];
+        struct token* property = declaration.property;
+        declaration_next(&declaration, o->source, cv);
+
+        // Everything in a custom property's value is kept as written.
+        if (declaration.value && declaration.custom) continue;
+
+        // The selector of a nested rule can look like a declaration, as in
+        // a:hover #aabbcc, but is kept as written.
+        if (statement) prelude = nested_rule(o->source, cv, last);
+        statement = cv_is(cv, TOKEN_SEMICOLON) ||
+                    (cv->type == CV_BLOCK && cv->data.block.end == TOKEN_RIGHT_CURLY);
+
+        if (declaration.property && declaration.property != property) {
+            names = atom_is(declaration.property->atom, KEYWORD_COLORS);
+        }
+
+        if (cv->type == CV_BLOCK && cv->data.block.end == TOKEN_RIGHT_CURLY) {
+            // A rule nested in an at-rule.
+            optimize_block(o, cv->children);
+        } else if (declaration.value && !prelude) {
+            optimize_value(o, cv, names);
+        }
+    }
+}
+
+void stylesheet_optimize(struct stylesheet* ss) {
+    struct optimizer o = {ss->arena, ss->source, ss->values};
+    for (size_t i = 0; i < ss->rule_count; i++) {
+        if (ss->rules[i].has_block) {
+            optimize_block(&o, ss->rules[i].block);
+        }
+    }
+}
+
+int crush_minify(const struct crush_context* context, const char* data, size_t size,
+                 struct output* out) {
+    struct lexer* L = lexer_new(data, size, INPUT_BORROWED);
+    lexer_set_context(L, context ? context : &default_context);
+    struct stylesheet* ss = parse_stylesheet(L);
+    stylesheet_optimize(ss);
+    stylesheet_write_minified(ss, out);
+    stylesheet_free(ss);
+    lexer_free(L);
+    return output_flush(out);
+}
@@ -1,5 +1,6 @@
 #pragma once
 #include <stdio.h>
+#include <stdbool.h>
 
 enum token_type
 {
@@ -26,6 +27,7 @@ enum token_type
     TOKEN_WHITESPACE,
     TOKEN_CDO,
     TOKEN_CDC,
+    TOKEN_COMMENT, // only /*! */ comments, and only when asked for
     TOKEN_COLON        = ':',
     TOKEN_SEMICOLON    = ';',
     TOKEN_COMMA        = ',',
@@ -37,9 +39,37 @@ enum token_type
     TOKEN_RIGHT_CURLY  = '}',
 };
 
+// Context
+// Options for the lexers that are given it, and where their parse errors go.
+// The library keeps no state of its own outside the objects it hands out and
+// only reads a context, so one context can serve parses on any number of
+// threads at once.
+struct crush_context {
+    bool preserve_comments; // as lexer_preserve_comments
+    // Called with each parse error, on the thread doing the parse. Null writes
+    // them to stderr.
+    void (*error)(void* data, const char* reason, unsigned line, unsigned column);
+    void* error_data;
+};
+// Comments dropped and errors written to stderr, as for a lexer not given one.
+void crush_context_init(struct crush_context* context);
+
 struct lexer;
 struct token;
+// Token text refers to the lexer's input rather than copying it, so the lexer
+// must outlive its tokens and any stylesheet parsed from it. Memory passed to
+// lexer_init_memory stays owned by the caller.
 struct lexer* lexer_init(FILE* input);
+struct lexer* lexer_init_memory(const char* data, size_t size);
+// Maps a regular file; anything else, like a pipe, is read as lexer_init does.
+struct lexer* lexer_init_mmap(const char* path);
+void lexer_free(struct lexer* L);
+// Keep /*! */ comments, which usually hold licenses, as TOKEN_COMMENT tokens
+// so they are written back out. Other comments are always dropped.
+void lexer_preserve_comments(struct lexer* L);
+// Take options from `context`, which must outlive the lexer and anything parsed
+// from it.
+void lexer_set_context(struct lexer* L, const struct crush_context* context);
 struct token* lexer_next(struct lexer* L);
 enum token_type token_type(struct token* t);
 const char* token_name(int t);
@@ -47,11 +77,107 @@ void token_free(struct token* t);
 
 // Test
 double token_number(struct token* t);
+// Idents, functions and at-keywords with the same name up to ASCII case, and
+// dimensions with that name as their unit, have the same atom. Other tokens
+// have 0.
+int token_atom(struct token* t);
 int token_range_low(struct token* t);
 int token_range_high(struct token* t);
 
 
+// Token tape
+// The whole token stream of an input at once, for reading in bulk: entry i of
+// each array describes token i, and the last token is always TOKEN_EOF. A
+// token's span starts after any comments before it. Values that are more than
+// the span, like numbers, delimiters and names without their escapes, are read
+// with the token_tape_* functions. Like tokens, a tape refers to the lexer's
+// input, which must outlive it.
+struct token_value;
+struct token_tape {
+    size_t count;
+    unsigned char* types;       // enum token_type
+    size_t* offsets;            // input offset of the token's first byte
+    size_t* lengths;            // input bytes the token spans
+    size_t* payloads;           // index into values, for tokens that have one
+    struct token_value* values; // private
+    size_t value_count;
+    unsigned char* strings;     // values that escapes made differ from the input
+    size_t strings_size;
+    const unsigned char* input;
+    const struct crush_context* context; // the lexer's, for parse errors
+};
+struct token_tape* lexer_tokenize_all(struct lexer* L);
+void token_tape_free(struct token_tape* tape);
+// The value of an ident, function, at-keyword, hash, string, url, comment or
+// numeric token, without the punctuation around it. Not terminated.
+const char* token_tape_text(struct token_tape* tape, size_t i, size_t* size);
+const char* token_tape_unit(struct token_tape* tape, size_t i, size_t* size);
+double token_tape_number(struct token_tape* tape, size_t i);
+int token_tape_delim(struct token_tape* tape, size_t i);
+int token_tape_range_low(struct token_tape* tape, size_t i);
+int token_tape_range_high(struct token_tape* tape, size_t i);
+
 // Parse
 struct stylesheet;
 struct stylesheet* parse_stylesheet(struct lexer* L);
+// Parses into `reuse`, a stylesheet that is no longer needed, rather than a
+// new one, so that a caller working through many files keeps the memory the
+// last one was parsed into. Null makes a new stylesheet.
+struct stylesheet* parse_stylesheet_reusing(struct lexer* L, struct stylesheet* reuse);
+// Parses as parse_stylesheet does, on up to `threads` threads at once for a
+// large input: it is cut between top-level rules and the pieces are parsed
+// side by side. The stylesheet and any parse errors are the same as
+// parse_stylesheet's. Only L's input and options are used.
+struct stylesheet* parse_stylesheet_parallel(struct lexer* L, unsigned threads);
+// Parses the tokens on a tape rather than pulling them from a lexer. The
+// stylesheet does not need the tape afterwards, only the input.
+struct stylesheet* parse_token_tape(struct token_tape* tape);
 void stylesheet_print(struct stylesheet* ss, FILE* file);
+
+// Rewrites values in place to shorter forms with the same meaning, such as
+// colors to their shortest hex or name.
+void stylesheet_optimize(struct stylesheet* ss);
+
+// A stylesheet's rules and component values are held in two flat arrays and
+// its tokens in one arena, all released in one go. Tokens returned by
+// lexer_next outside of a parse are not part of it and are freed with
+// token_free.
+void stylesheet_free(struct stylesheet* ss);
+
+struct crush_stats {
+    size_t allocations; // tokens, component values, rules and buffers
+    size_t mallocs;     // heap allocations made to hold them
+    size_t bytes;       // heap bytes held
+};
+void stylesheet_stats(struct stylesheet* ss, struct crush_stats* stats);
+// Test
+// The atoms of the named tokens in a stylesheet, in the order they are written.
+// Returns how many there are, of which the first `max` are stored.
+size_t stylesheet_atoms(struct stylesheet* ss, int* atoms, size_t max);
+
+// Output
+// A buffered sink for printed stylesheets: bytes are collected in user space
+// and passed to the FILE or descriptor in large writes, or kept in a growable
+// buffer in memory. Nothing reaches a file or descriptor until the buffer
+// fills, output_flush is called, or the output is freed.
+struct output;
+struct output* output_file(FILE* file);
+struct output* output_fd(int fd);
+struct output* output_memory(void);
+void output_write(struct output* out, const void* data, size_t size);
+int output_flush(struct output* out); // 0 on success, EOF if any write failed
+const char* output_data(struct output* out, size_t* size); // memory outputs only
+void output_free(struct output* out);
+
+void stylesheet_write(struct stylesheet* ss, struct output* out);
+// Writes the fewest bytes that read back as the same stylesheet: whitespace
+// only where tokens would otherwise run together, no newlines, and no
+// semicolon before a closing brace.
+void stylesheet_write_minified(struct stylesheet* ss, struct output* out);
+
+// Parses, optimizes and writes minified the `size` bytes at `data` in one go.
+// Safe to call from many threads at once, with one context or several, as
+// long as each has its own output. A null context has the defaults. Returns
+// output_flush's result.
+int crush_minify(const struct crush_context* context, const char* data, size_t size,
+                 struct output* out);
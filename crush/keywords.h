@@ -0,0 +1,1664 @@
+// Generated by tools/keywords.py from tools/keywords.txt. Do not edit.
+#pragma once
+#include <stdint.h>
+
+enum keyword_flags {
+    KEYWORD_PROPERTY = 1 << 0,
+    KEYWORD_AT_RULE = 1 << 1,
+    KEYWORD_UNIT = 1 << 2,
+    KEYWORD_PSEUDO_CLASS = 1 << 3,
+    KEYWORD_FUNCTION = 1 << 4,
+    KEYWORD_VALUE = 1 << 5,
+    KEYWORD_LENGTH = 1 << 6,
+    KEYWORD_COLORS = 1 << 7,
+};
+
+enum atom {
+    NO_ATOM,
+    ATOM_MS_FLEX,
+    ATOM_WEBKIT_APPEARANCE,
+    ATOM_WEBKIT_BOX_ORIENT,
+    ATOM_WEBKIT_FLEX,
+    ATOM_WEBKIT_FONT_SMOOTHING,
+    ATOM_WEBKIT_LINE_CLAMP,
+    ATOM_WEBKIT_OVERFLOW_SCROLLING,
+    ATOM_WEBKIT_TAP_HIGHLIGHT_COLOR,
+    ATOM_WEBKIT_TEXT_FILL_COLOR,
+    ATOM_WEBKIT_TEXT_SIZE_ADJUST,
+    ATOM_WEBKIT_TEXT_STROKE,
+    ATOM_WEBKIT_TEXT_STROKE_COLOR,
+    ATOM_WEBKIT_TEXT_STROKE_WIDTH,
+    ATOM_WEBKIT_USER_SELECT,
+    ATOM_ACCENT_COLOR,
+    ATOM_ACTIVE,
+    ATOM_ALIGN_CONTENT,
+    ATOM_ALIGN_ITEMS,
+    ATOM_ALIGN_SELF,
+    ATOM_ALL,
+    ATOM_ANIMATION,
+    ATOM_ANIMATION_COMPOSITION,
+    ATOM_ANIMATION_DELAY,
+    ATOM_ANIMATION_DIRECTION,
+    ATOM_ANIMATION_DURATION,
+    ATOM_ANIMATION_FILL_MODE,
+    ATOM_ANIMATION_ITERATION_COUNT,
+    ATOM_ANIMATION_NAME,
+    ATOM_ANIMATION_PLAY_STATE,
+    ATOM_ANIMATION_TIMING_FUNCTION,
+    ATOM_ANY_LINK,
+    ATOM_APPEARANCE,
+    ATOM_ASPECT_RATIO,
+    ATOM_ATTR,
+    ATOM_AUTO,
+    ATOM_BACKDROP_FILTER,
+    ATOM_BACKFACE_VISIBILITY,
+    ATOM_BACKGROUND,
+    ATOM_BACKGROUND_ATTACHMENT,
+    ATOM_BACKGROUND_BLEND_MODE,
+    ATOM_BACKGROUND_CLIP,
+    ATOM_BACKGROUND_COLOR,
+    ATOM_BACKGROUND_IMAGE,
+    ATOM_BACKGROUND_ORIGIN,
+    ATOM_BACKGROUND_POSITION,
+    ATOM_BACKGROUND_POSITION_X,
+    ATOM_BACKGROUND_POSITION_Y,
+    ATOM_BACKGROUND_REPEAT,
+    ATOM_BACKGROUND_SIZE,
+    ATOM_BLOCK_SIZE,
+    ATOM_BORDER,
+    ATOM_BORDER_BLOCK,
+    ATOM_BORDER_BLOCK_COLOR,
+    ATOM_BORDER_BLOCK_END,
+    ATOM_BORDER_BLOCK_END_COLOR,
+    ATOM_BORDER_BLOCK_END_STYLE,
+    ATOM_BORDER_BLOCK_END_WIDTH,
+    ATOM_BORDER_BLOCK_START,
+    ATOM_BORDER_BLOCK_START_COLOR,
+    ATOM_BORDER_BLOCK_START_STYLE,
+    ATOM_BORDER_BLOCK_START_WIDTH,
+    ATOM_BORDER_BLOCK_STYLE,
+    ATOM_BORDER_BLOCK_WIDTH,
+    ATOM_BORDER_BOTTOM,
+    ATOM_BORDER_BOTTOM_COLOR,
+    ATOM_BORDER_BOTTOM_LEFT_RADIUS,
+    ATOM_BORDER_BOTTOM_RIGHT_RADIUS,
+    ATOM_BORDER_BOTTOM_STYLE,
+    ATOM_BORDER_BOTTOM_WIDTH,
+    ATOM_BORDER_COLLAPSE,
+    ATOM_BORDER_COLOR,
+    ATOM_BORDER_END_END_RADIUS,
+    ATOM_BORDER_END_START_RADIUS,
+    ATOM_BORDER_IMAGE,
+    ATOM_BORDER_IMAGE_OUTSET,
+    ATOM_BORDER_IMAGE_REPEAT,
+    ATOM_BORDER_IMAGE_SLICE,
+    ATOM_BORDER_IMAGE_SOURCE,
+    ATOM_BORDER_IMAGE_WIDTH,
+    ATOM_BORDER_INLINE,
+    ATOM_BORDER_INLINE_COLOR,
+    ATOM_BORDER_INLINE_END,
+    ATOM_BORDER_INLINE_END_COLOR,
+    ATOM_BORDER_INLINE_END_STYLE,
+    ATOM_BORDER_INLINE_END_WIDTH,
+    ATOM_BORDER_INLINE_START,
+    ATOM_BORDER_INLINE_START_COLOR,
+    ATOM_BORDER_INLINE_START_STYLE,
+    ATOM_BORDER_INLINE_START_WIDTH,
+    ATOM_BORDER_INLINE_STYLE,
+    ATOM_BORDER_INLINE_WIDTH,
+    ATOM_BORDER_LEFT,
+    ATOM_BORDER_LEFT_COLOR,
+    ATOM_BORDER_LEFT_STYLE,
+    ATOM_BORDER_LEFT_WIDTH,
+    ATOM_BORDER_RADIUS,
+    ATOM_BORDER_RIGHT,
+    ATOM_BORDER_RIGHT_COLOR,
+    ATOM_BORDER_RIGHT_STYLE,
+    ATOM_BORDER_RIGHT_WIDTH,
+    ATOM_BORDER_SPACING,
+    ATOM_BORDER_START_END_RADIUS,
+    ATOM_BORDER_START_START_RADIUS,
+    ATOM_BORDER_STYLE,
+    ATOM_BORDER_TOP,
+    ATOM_BORDER_TOP_COLOR,
+    ATOM_BORDER_TOP_LEFT_RADIUS,
+    ATOM_BORDER_TOP_RIGHT_RADIUS,
+    ATOM_BORDER_TOP_STYLE,
+    ATOM_BORDER_TOP_WIDTH,
+    ATOM_BORDER_WIDTH,
+    ATOM_BOTTOM,
+    ATOM_BOX_DECORATION_BREAK,
+    ATOM_BOX_SHADOW,
+    ATOM_BOX_SIZING,
+    ATOM_BREAK_AFTER,
+    ATOM_BREAK_BEFORE,
+    ATOM_BREAK_INSIDE,
+    ATOM_CALC,
+    ATOM_CAP,
+    ATOM_CAPTION_SIDE,
+    ATOM_CARET_COLOR,
+    ATOM_CH,
+    ATOM_CHARSET,
+    ATOM_CHECKED,
+    ATOM_CLAMP,
+    ATOM_CLEAR,
+    ATOM_CLIP,
+    ATOM_CLIP_PATH,
+    ATOM_CM,
+    ATOM_COLOR,
+    ATOM_COLOR_MIX,
+    ATOM_COLOR_SCHEME,
+    ATOM_COLUMN_COUNT,
+    ATOM_COLUMN_FILL,
+    ATOM_COLUMN_GAP,
+    ATOM_COLUMN_RULE,
+    ATOM_COLUMN_RULE_COLOR,
+    ATOM_COLUMN_RULE_STYLE,
+    ATOM_COLUMN_RULE_WIDTH,
+    ATOM_COLUMN_SPAN,
+    ATOM_COLUMN_WIDTH,
+    ATOM_COLUMNS,
+    ATOM_CONIC_GRADIENT,
+    ATOM_CONTAIN,
+    ATOM_CONTAINER,
+    ATOM_CONTAINER_NAME,
+    ATOM_CONTAINER_TYPE,
+    ATOM_CONTENT,
+    ATOM_CONTENT_VISIBILITY,
+    ATOM_COUNTER,
+    ATOM_COUNTER_INCREMENT,
+    ATOM_COUNTER_RESET,
+    ATOM_COUNTER_SET,
+    ATOM_COUNTER_STYLE,
+    ATOM_CQB,
+    ATOM_CQH,
+    ATOM_CQI,
+    ATOM_CQMAX,
+    ATOM_CQMIN,
+    ATOM_CQW,
+    ATOM_CURRENTCOLOR,
+    ATOM_CURSOR,
+    ATOM_DEFAULT,
+    ATOM_DEFINED,
+    ATOM_DEG,
+    ATOM_DIRECTION,
+    ATOM_DISABLED,
+    ATOM_DISPLAY,
+    ATOM_DOCUMENT,
+    ATOM_DPCM,
+    ATOM_DPI,
+    ATOM_DPPX,
+    ATOM_DROP_SHADOW,
+    ATOM_DVH,
+    ATOM_DVW,
+    ATOM_EM,
+    ATOM_EMPTY,
+    ATOM_EMPTY_CELLS,
+    ATOM_ENABLED,
+    ATOM_ENV,
+    ATOM_EX,
+    ATOM_FILL,
+    ATOM_FILL_OPACITY,
+    ATOM_FILL_RULE,
+    ATOM_FILTER,
+    ATOM_FIRST,
+    ATOM_FIRST_CHILD,
+    ATOM_FIRST_OF_TYPE,
+    ATOM_FLEX,
+    ATOM_FLEX_BASIS,
+    ATOM_FLEX_DIRECTION,
+    ATOM_FLEX_FLOW,
+    ATOM_FLEX_GROW,
+    ATOM_FLEX_SHRINK,
+    ATOM_FLEX_WRAP,
+    ATOM_FLOAT,
+    ATOM_FLOOD_COLOR,
+    ATOM_FLOOD_OPACITY,
+    ATOM_FOCUS,
+    ATOM_FOCUS_VISIBLE,
+    ATOM_FOCUS_WITHIN,
+    ATOM_FONT,
+    ATOM_FONT_DISPLAY,
+    ATOM_FONT_FACE,
+    ATOM_FONT_FAMILY,
+    ATOM_FONT_FEATURE_SETTINGS,
+    ATOM_FONT_FEATURE_VALUES,
+    ATOM_FONT_KERNING,
+    ATOM_FONT_OPTICAL_SIZING,
+    ATOM_FONT_PALETTE_VALUES,
+    ATOM_FONT_SIZE,
+    ATOM_FONT_SIZE_ADJUST,
+    ATOM_FONT_STRETCH,
+    ATOM_FONT_STYLE,
+    ATOM_FONT_SYNTHESIS,
+    ATOM_FONT_VARIANT,
+    ATOM_FONT_VARIANT_CAPS,
+    ATOM_FONT_VARIANT_EAST_ASIAN,
+    ATOM_FONT_VARIANT_LIGATURES,
+    ATOM_FONT_VARIANT_NUMERIC,
+    ATOM_FONT_VARIATION_SETTINGS,
+    ATOM_FONT_WEIGHT,
+    ATOM_FR,
+    ATOM_FULLSCREEN,
+    ATOM_GAP,
+    ATOM_GRAD,
+    ATOM_GRID,
+    ATOM_GRID_AREA,
+    ATOM_GRID_AUTO_COLUMNS,
+    ATOM_GRID_AUTO_FLOW,
+    ATOM_GRID_AUTO_ROWS,
+    ATOM_GRID_COLUMN,
+    ATOM_GRID_COLUMN_END,
+    ATOM_GRID_COLUMN_GAP,
+    ATOM_GRID_COLUMN_START,
+    ATOM_GRID_GAP,
+    ATOM_GRID_ROW,
+    ATOM_GRID_ROW_END,
+    ATOM_GRID_ROW_GAP,
+    ATOM_GRID_ROW_START,
+    ATOM_GRID_TEMPLATE,
+    ATOM_GRID_TEMPLATE_AREAS,
+    ATOM_GRID_TEMPLATE_COLUMNS,
+    ATOM_GRID_TEMPLATE_ROWS,
+    ATOM_HAS,
+    ATOM_HEIGHT,
+    ATOM_HOST,
+    ATOM_HOVER,
+    ATOM_HSL,
+    ATOM_HSLA,
+    ATOM_HYPHENS,
+    ATOM_HZ,
+    ATOM_IC,
+    ATOM_IMAGE_RENDERING,
+    ATOM_IMPORT,
+    ATOM_IN,
+    ATOM_IN_RANGE,
+    ATOM_INDETERMINATE,
+    ATOM_INHERIT,
+    ATOM_INITIAL,
+    ATOM_INLINE_SIZE,
+    ATOM_INSET,
+    ATOM_INSET_BLOCK,
+    ATOM_INSET_BLOCK_END,
+    ATOM_INSET_BLOCK_START,
+    ATOM_INSET_INLINE,
+    ATOM_INSET_INLINE_END,
+    ATOM_INSET_INLINE_START,
+    ATOM_INVALID,
+    ATOM_IS,
+    ATOM_ISOLATION,
+    ATOM_JUSTIFY_CONTENT,
+    ATOM_JUSTIFY_ITEMS,
+    ATOM_JUSTIFY_SELF,
+    ATOM_KEYFRAMES,
+    ATOM_KHZ,
+    ATOM_LANG,
+    ATOM_LAST_CHILD,
+    ATOM_LAST_OF_TYPE,
+    ATOM_LAYER,
+    ATOM_LEFT,
+    ATOM_LETTER_SPACING,
+    ATOM_LH,
+    ATOM_LIGHT_DARK,
+    ATOM_LIGHTING_COLOR,
+    ATOM_LINE_BREAK,
+    ATOM_LINE_HEIGHT,
+    ATOM_LINEAR_GRADIENT,
+    ATOM_LINK,
+    ATOM_LIST_STYLE,
+    ATOM_LIST_STYLE_IMAGE,
+    ATOM_LIST_STYLE_POSITION,
+    ATOM_LIST_STYLE_TYPE,
+    ATOM_LVH,
+    ATOM_LVW,
+    ATOM_MARGIN,
+    ATOM_MARGIN_BLOCK,
+    ATOM_MARGIN_BLOCK_END,
+    ATOM_MARGIN_BLOCK_START,
+    ATOM_MARGIN_BOTTOM,
+    ATOM_MARGIN_INLINE,
+    ATOM_MARGIN_INLINE_END,
+    ATOM_MARGIN_INLINE_START,
+    ATOM_MARGIN_LEFT,
+    ATOM_MARGIN_RIGHT,
+    ATOM_MARGIN_TOP,
+    ATOM_MARKER,
+    ATOM_MASK,
+    ATOM_MASK_IMAGE,
+    ATOM_MASK_POSITION,
+    ATOM_MASK_REPEAT,
+    ATOM_MASK_SIZE,
+    ATOM_MAX,
+    ATOM_MAX_BLOCK_SIZE,
+    ATOM_MAX_HEIGHT,
+    ATOM_MAX_INLINE_SIZE,
+    ATOM_MAX_WIDTH,
+    ATOM_MEDIA,
+    ATOM_MIN,
+    ATOM_MIN_BLOCK_SIZE,
+    ATOM_MIN_HEIGHT,
+    ATOM_MIN_INLINE_SIZE,
+    ATOM_MIN_WIDTH,
+    ATOM_MIX_BLEND_MODE,
+    ATOM_MM,
+    ATOM_MS,
+    ATOM_NAMESPACE,
+    ATOM_NONE,
+    ATOM_NORMAL,
+    ATOM_NOT,
+    ATOM_NTH_CHILD,
+    ATOM_NTH_LAST_CHILD,
+    ATOM_NTH_LAST_OF_TYPE,
+    ATOM_NTH_OF_TYPE,
+    ATOM_OBJECT_FIT,
+    ATOM_OBJECT_POSITION,
+    ATOM_OFFSET,
+    ATOM_ONLY_CHILD,
+    ATOM_ONLY_OF_TYPE,
+    ATOM_OPACITY,
+    ATOM_OPTIONAL,
+    ATOM_ORDER,
+    ATOM_ORPHANS,
+    ATOM_OUT_OF_RANGE,
+    ATOM_OUTLINE,
+    ATOM_OUTLINE_COLOR,
+    ATOM_OUTLINE_OFFSET,
+    ATOM_OUTLINE_STYLE,
+    ATOM_OUTLINE_WIDTH,
+    ATOM_OVERFLOW,
+    ATOM_OVERFLOW_ANCHOR,
+    ATOM_OVERFLOW_WRAP,
+    ATOM_OVERFLOW_X,
+    ATOM_OVERFLOW_Y,
+    ATOM_OVERSCROLL_BEHAVIOR,
+    ATOM_OVERSCROLL_BEHAVIOR_X,
+    ATOM_OVERSCROLL_BEHAVIOR_Y,
+    ATOM_PADDING,
+    ATOM_PADDING_BLOCK,
+    ATOM_PADDING_BLOCK_END,
+    ATOM_PADDING_BLOCK_START,
+    ATOM_PADDING_BOTTOM,
+    ATOM_PADDING_INLINE,
+    ATOM_PADDING_INLINE_END,
+    ATOM_PADDING_INLINE_START,
+    ATOM_PADDING_LEFT,
+    ATOM_PADDING_RIGHT,
+    ATOM_PADDING_TOP,
+    ATOM_PAGE,
+    ATOM_PAGE_BREAK_AFTER,
+    ATOM_PAGE_BREAK_BEFORE,
+    ATOM_PAGE_BREAK_INSIDE,
+    ATOM_PAINT_ORDER,
+    ATOM_PC,
+    ATOM_PERSPECTIVE,
+    ATOM_PERSPECTIVE_ORIGIN,
+    ATOM_PLACE_CONTENT,
+    ATOM_PLACE_ITEMS,
+    ATOM_PLACE_SELF,
+    ATOM_PLACEHOLDER_SHOWN,
+    ATOM_POINTER_EVENTS,
+    ATOM_POSITION,
+    ATOM_PRINT_COLOR_ADJUST,
+    ATOM_PROPERTY,
+    ATOM_PT,
+    ATOM_PX,
+    ATOM_Q,
+    ATOM_QUOTES,
+    ATOM_RAD,
+    ATOM_RADIAL_GRADIENT,
+    ATOM_READ_ONLY,
+    ATOM_READ_WRITE,
+    ATOM_REM,
+    ATOM_REPEATING_CONIC_GRADIENT,
+    ATOM_REPEATING_LINEAR_GRADIENT,
+    ATOM_REPEATING_RADIAL_GRADIENT,
+    ATOM_REQUIRED,
+    ATOM_RESIZE,
+    ATOM_REVERT,
+    ATOM_RGB,
+    ATOM_RGBA,
+    ATOM_RIGHT,
+    ATOM_RLH,
+    ATOM_ROOT,
+    ATOM_ROTATE,
+    ATOM_ROW_GAP,
+    ATOM_S,
+    ATOM_SCALE,
+    ATOM_SCOPE,
+    ATOM_SCROLL_BEHAVIOR,
+    ATOM_SCROLL_MARGIN,
+    ATOM_SCROLL_MARGIN_BLOCK,
+    ATOM_SCROLL_MARGIN_BOTTOM,
+    ATOM_SCROLL_MARGIN_INLINE,
+    ATOM_SCROLL_MARGIN_LEFT,
+    ATOM_SCROLL_MARGIN_RIGHT,
+    ATOM_SCROLL_MARGIN_TOP,
+    ATOM_SCROLL_PADDING,
+    ATOM_SCROLL_PADDING_BLOCK,
+    ATOM_SCROLL_PADDING_BOTTOM,
+    ATOM_SCROLL_PADDING_INLINE,
+    ATOM_SCROLL_PADDING_LEFT,
+    ATOM_SCROLL_PADDING_RIGHT,
+    ATOM_SCROLL_PADDING_TOP,
+    ATOM_SCROLL_SNAP_ALIGN,
+    ATOM_SCROLL_SNAP_STOP,
+    ATOM_SCROLL_SNAP_TYPE,
+    ATOM_SCROLLBAR_COLOR,
+    ATOM_SCROLLBAR_GUTTER,
+    ATOM_SCROLLBAR_WIDTH,
+    ATOM_SHAPE_IMAGE_THRESHOLD,
+    ATOM_SHAPE_MARGIN,
+    ATOM_SHAPE_OUTSIDE,
+    ATOM_SPEAK,
+    ATOM_SRC,
+    ATOM_STARTING_STYLE,
+    ATOM_STOP_COLOR,
+    ATOM_STOP_OPACITY,
+    ATOM_STROKE,
+    ATOM_STROKE_DASHARRAY,
+    ATOM_STROKE_DASHOFFSET,
+    ATOM_STROKE_LINECAP,
+    ATOM_STROKE_LINEJOIN,
+    ATOM_STROKE_MITERLIMIT,
+    ATOM_STROKE_OPACITY,
+    ATOM_STROKE_WIDTH,
+    ATOM_SUPPORTS,
+    ATOM_SVH,
+    ATOM_SVW,
+    ATOM_TAB_SIZE,
+    ATOM_TABLE_LAYOUT,
+    ATOM_TARGET,
+    ATOM_TEXT_ALIGN,
+    ATOM_TEXT_ALIGN_LAST,
+    ATOM_TEXT_COMBINE_UPRIGHT,
+    ATOM_TEXT_DECORATION,
+    ATOM_TEXT_DECORATION_COLOR,
+    ATOM_TEXT_DECORATION_LINE,
+    ATOM_TEXT_DECORATION_SKIP_INK,
+    ATOM_TEXT_DECORATION_STYLE,
+    ATOM_TEXT_DECORATION_THICKNESS,
+    ATOM_TEXT_EMPHASIS,
+    ATOM_TEXT_EMPHASIS_COLOR,
+    ATOM_TEXT_EMPHASIS_POSITION,
+    ATOM_TEXT_EMPHASIS_STYLE,
+    ATOM_TEXT_INDENT,
+    ATOM_TEXT_JUSTIFY,
+    ATOM_TEXT_ORIENTATION,
+    ATOM_TEXT_OVERFLOW,
+    ATOM_TEXT_RENDERING,
+    ATOM_TEXT_SHADOW,
+    ATOM_TEXT_SIZE_ADJUST,
+    ATOM_TEXT_TRANSFORM,
+    ATOM_TEXT_UNDERLINE_OFFSET,
+    ATOM_TEXT_UNDERLINE_POSITION,
+    ATOM_TEXT_WRAP,
+    ATOM_TOP,
+    ATOM_TOUCH_ACTION,
+    ATOM_TRANSFORM,
+    ATOM_TRANSFORM_BOX,
+    ATOM_TRANSFORM_ORIGIN,
+    ATOM_TRANSFORM_STYLE,
+    ATOM_TRANSITION,
+    ATOM_TRANSITION_BEHAVIOR,
+    ATOM_TRANSITION_DELAY,
+    ATOM_TRANSITION_DURATION,
+    ATOM_TRANSITION_PROPERTY,
+    ATOM_TRANSITION_TIMING_FUNCTION,
+    ATOM_TRANSLATE,
+    ATOM_TRANSPARENT,
+    ATOM_TURN,
+    ATOM_UNICODE_BIDI,
+    ATOM_UNICODE_RANGE,
+    ATOM_UNSET,
+    ATOM_URL,
+    ATOM_USER_SELECT,
+    ATOM_VALID,
+    ATOM_VAR,
+    ATOM_VB,
+    ATOM_VERTICAL_ALIGN,
+    ATOM_VH,
+    ATOM_VI,
+    ATOM_VIEWPORT,
+    ATOM_VISIBILITY,
+    ATOM_VISITED,
+    ATOM_VMAX,
+    ATOM_VMIN,
+    ATOM_VW,
+    ATOM_WHERE,
+    ATOM_WHITE_SPACE,
+    ATOM_WIDOWS,
+    ATOM_WIDTH,
+    ATOM_WILL_CHANGE,
+    ATOM_WORD_BREAK,
+    ATOM_WORD_SPACING,
+    ATOM_WORD_WRAP,
+    ATOM_WRITING_MODE,
+    ATOM_X,
+    ATOM_Z_INDEX,
+    ATOM_ZOOM,
+    ATOM_KEYWORD_COUNT
+};
+
+struct keyword {
+    const char* name;
+    unsigned char length;
+    unsigned short flags;
+};
+
+static const struct keyword keywords[] = {
+    [NO_ATOM]                          = {"", 0, 0},
+    [ATOM_MS_FLEX]                     = {"-ms-flex", 8, KEYWORD_PROPERTY},
+    [ATOM_WEBKIT_APPEARANCE]           = {"-webkit-appearance", 18, KEYWORD_PROPERTY},
+    [ATOM_WEBKIT_BOX_ORIENT]           = {"-webkit-box-orient", 18, KEYWORD_PROPERTY},
+    [ATOM_WEBKIT_FLEX]                 = {"-webkit-flex", 12, KEYWORD_PROPERTY},
+    [ATOM_WEBKIT_FONT_SMOOTHING]       = {"-webkit-font-smoothing", 22, KEYWORD_PROPERTY},
+    [ATOM_WEBKIT_LINE_CLAMP]           = {"-webkit-line-clamp", 18, KEYWORD_PROPERTY},
+    [ATOM_WEBKIT_OVERFLOW_SCROLLING]   = {"-webkit-overflow-scrolling", 26, KEYWORD_PROPERTY},
+    [ATOM_WEBKIT_TAP_HIGHLIGHT_COLOR]  = {"-webkit-tap-highlight-color", 27, KEYWORD_COLORS | KEYWORD_PROPERTY},
+    [ATOM_WEBKIT_TEXT_FILL_COLOR]      = {"-webkit-text-fill-color", 23, KEYWORD_COLORS | KEYWORD_PROPERTY},
+    [ATOM_WEBKIT_TEXT_SIZE_ADJUST]     = {"-webkit-text-size-adjust", 24, KEYWORD_PROPERTY},
+    [ATOM_WEBKIT_TEXT_STROKE]          = {"-webkit-text-stroke", 19, KEYWORD_PROPERTY},
+    [ATOM_WEBKIT_TEXT_STROKE_COLOR]    = {"-webkit-text-stroke-color", 25, KEYWORD_COLORS | KEYWORD_PROPERTY},
+    [ATOM_WEBKIT_TEXT_STROKE_WIDTH]    = {"-webkit-text-stroke-width", 25, KEYWORD_PROPERTY},
+    [ATOM_WEBKIT_USER_SELECT]          = {"-webkit-user-select", 19, KEYWORD_PROPERTY},
+    [ATOM_ACCENT_COLOR]                = {"accent-color", 12, KEYWORD_COLORS | KEYWORD_PROPERTY},
+    [ATOM_ACTIVE]                      = {"active", 6, KEYWORD_PSEUDO_CLASS},
+    [ATOM_ALIGN_CONTENT]               = {"align-content", 13, KEYWORD_PROPERTY},
+    [ATOM_ALIGN_ITEMS]                 = {"align-items", 11, KEYWORD_PROPERTY},
+    [ATOM_ALIGN_SELF]                  = {"align-self", 10, KEYWORD_PROPERTY},
+    [ATOM_ALL]                         = {"all", 3, KEYWORD_PROPERTY},
+    [ATOM_ANIMATION]                   = {"animation", 9, KEYWORD_PROPERTY},
+    [ATOM_ANIMATION_COMPOSITION]       = {"animation-composition", 21, KEYWORD_PROPERTY},
+    [ATOM_ANIMATION_DELAY]             = {"animation-delay", 15, KEYWORD_PROPERTY},
+    [ATOM_ANIMATION_DIRECTION]         = {"animation-direction", 19, KEYWORD_PROPERTY},
+    [ATOM_ANIMATION_DURATION]          = {"animation-duration", 18, KEYWORD_PROPERTY},
+    [ATOM_ANIMATION_FILL_MODE]         = {"animation-fill-mode", 19, KEYWORD_PROPERTY},
+    [ATOM_ANIMATION_ITERATION_COUNT]   = {"animation-iteration-count", 25, KEYWORD_PROPERTY},
+    [ATOM_ANIMATION_NAME]              = {"animation-name", 14, KEYWORD_PROPERTY},
+    [ATOM_ANIMATION_PLAY_STATE]        = {"animation-play-state", 20, KEYWORD_PROPERTY},
+    [ATOM_ANIMATION_TIMING_FUNCTION]   = {"animation-timing-function", 25, KEYWORD_PROPERTY},
+    [ATOM_ANY_LINK]                    = {"any-link", 8, KEYWORD_PSEUDO_CLASS},
+    [ATOM_APPEARANCE]                  = {"appearance", 10, KEYWORD_PROPERTY},
+    [ATOM_ASPECT_RATIO]                = {"aspect-ratio", 12, KEYWORD_PROPERTY},
+    [ATOM_ATTR]                        = {"attr", 4, KEYWORD_FUNCTION},
+    [ATOM_AUTO]                        = {"auto", 4, KEYWORD_VALUE},
+    [ATOM_BACKDROP_FILTER]             = {"backdrop-filter", 15, KEYWORD_PROPERTY},
+    [ATOM_BACKFACE_VISIBILITY]         = {"backface-visibility", 19, KEYWORD_PROPERTY},
+    [ATOM_BACKGROUND]                  = {"background", 10, KEYWORD_COLORS | KEYWORD_PROPERTY},
+    [ATOM_BACKGROUND_ATTACHMENT]       = {"background-attachment", 21, KEYWORD_PROPERTY},
+    [ATOM_BACKGROUND_BLEND_MODE]       = {"background-blend-mode", 21, KEYWORD_PROPERTY},
+    [ATOM_BACKGROUND_CLIP]             = {"background-clip", 15, KEYWORD_PROPERTY},
+    [ATOM_BACKGROUND_COLOR]            = {"background-color", 16, KEYWORD_COLORS | KEYWORD_PROPERTY},
+    [ATOM_BACKGROUND_IMAGE]            = {"background-image", 16, KEYWORD_PROPERTY},
+    [ATOM_BACKGROUND_ORIGIN]           = {"background-origin", 17, KEYWORD_PROPERTY},
+    [ATOM_BACKGROUND_POSITION]         = {"background-position", 19, KEYWORD_PROPERTY},
+    [ATOM_BACKGROUND_POSITION_X]       = {"background-position-x", 21, KEYWORD_PROPERTY},
+    [ATOM_BACKGROUND_POSITION_Y]       = {"background-position-y", 21, KEYWORD_PROPERTY},
+    [ATOM_BACKGROUND_REPEAT]           = {"background-repeat", 17, KEYWORD_PROPERTY},
+    [ATOM_BACKGROUND_SIZE]             = {"background-size", 15, KEYWORD_PROPERTY},
+    [ATOM_BLOCK_SIZE]                  = {"block-size", 10, KEYWORD_PROPERTY},
+    [ATOM_BORDER]                      = {"border", 6, KEYWORD_COLORS | KEYWORD_PROPERTY},
+    [ATOM_BORDER_BLOCK]                = {"border-block", 12, KEYWORD_COLORS | KEYWORD_PROPERTY},
+    [ATOM_BORDER_BLOCK_COLOR]          = {"border-block-color", 18, KEYWORD_COLORS | KEYWORD_PROPERTY},
+    [ATOM_BORDER_BLOCK_END]            = {"border-block-end", 16, KEYWORD_COLORS | KEYWORD_PROPERTY},
+    [ATOM_BORDER_BLOCK_END_COLOR]      = {"border-block-end-color", 22, KEYWORD_COLORS | KEYWORD_PROPERTY},
+    [ATOM_BORDER_BLOCK_END_STYLE]      = {"border-block-end-style", 22, KEYWORD_PROPERTY},
+    [ATOM_BORDER_BLOCK_END_WIDTH]      = {"border-block-end-width", 22, KEYWORD_PROPERTY},
+    [ATOM_BORDER_BLOCK_START]          = {"border-block-start", 18, KEYWORD_COLORS | KEYWORD_PROPERTY},
+    [ATOM_BORDER_BLOCK_START_COLOR]    = {"border-block-start-color", 24, KEYWORD_COLORS | KEYWORD_PROPERTY},
+    [ATOM_BORDER_BLOCK_START_STYLE]    = {"border-block-start-style", 24, KEYWORD_PROPERTY},
+    [ATOM_BORDER_BLOCK_START_WIDTH]    = {"border-block-start-width", 24, KEYWORD_PROPERTY},
+    [ATOM_BORDER_BLOCK_STYLE]          = {"border-block-style", 18, KEYWORD_PROPERTY},
+    [ATOM_BORDER_BLOCK_WIDTH]          = {"border-block-width", 18, KEYWORD_PROPERTY},
+    [ATOM_BORDER_BOTTOM]               = {"border-bottom", 13, KEYWORD_COLORS | KEYWORD_PROPERTY},
+    [ATOM_BORDER_BOTTOM_COLOR]         = {"border-bottom-color", 19, KEYWORD_COLORS | KEYWORD_PROPERTY},
+    [ATOM_BORDER_BOTTOM_LEFT_RADIUS]   = {"border-bottom-left-radius", 25, KEYWORD_PROPERTY},
+    [ATOM_BORDER_BOTTOM_RIGHT_RADIUS]  = {"border-bottom-right-radius", 26, KEYWORD_PROPERTY},
+    [ATOM_BORDER_BOTTOM_STYLE]         = {"border-bottom-style", 19, KEYWORD_PROPERTY},
+    [ATOM_BORDER_BOTTOM_WIDTH]         = {"border-bottom-width", 19, KEYWORD_PROPERTY},
+    [ATOM_BORDER_COLLAPSE]             = {"border-collapse", 15, KEYWORD_PROPERTY},
+    [ATOM_BORDER_COLOR]                = {"border-color", 12, KEYWORD_COLORS | KEYWORD_PROPERTY},
+    [ATOM_BORDER_END_END_RADIUS]       = {"border-end-end-radius", 21, KEYWORD_PROPERTY},
+    [ATOM_BORDER_END_START_RADIUS]     = {"border-end-start-radius", 23, KEYWORD_PROPERTY},
+    [ATOM_BORDER_IMAGE]                = {"border-image", 12, KEYWORD_PROPERTY},
+    [ATOM_BORDER_IMAGE_OUTSET]         = {"border-image-outset", 19, KEYWORD_PROPERTY},
+    [ATOM_BORDER_IMAGE_REPEAT]         = {"border-image-repeat", 19, KEYWORD_PROPERTY},
+    [ATOM_BORDER_IMAGE_SLICE]          = {"border-image-slice", 18, KEYWORD_PROPERTY},
+    [ATOM_BORDER_IMAGE_SOURCE]         = {"border-image-source", 19, KEYWORD_PROPERTY},
+    [ATOM_BORDER_IMAGE_WIDTH]          = {"border-image-width", 18, KEYWORD_PROPERTY},
+    [ATOM_BORDER_INLINE]               = {"border-inline", 13, KEYWORD_COLORS | KEYWORD_PROPERTY},
+    [ATOM_BORDER_INLINE_COLOR]         = {"border-inline-color", 19, KEYWORD_COLORS | KEYWORD_PROPERTY},
+    [ATOM_BORDER_INLINE_END]           = {"border-inline-end", 17, KEYWORD_COLORS | KEYWORD_PROPERTY},
+    [ATOM_BORDER_INLINE_END_COLOR]     = {"border-inline-end-color", 23, KEYWORD_COLORS | KEYWORD_PROPERTY},
+    [ATOM_BORDER_INLINE_END_STYLE]     = {"border-inline-end-style", 23, KEYWORD_PROPERTY},
+    [ATOM_BORDER_INLINE_END_WIDTH]     = {"border-inline-end-width", 23, KEYWORD_PROPERTY},
+    [ATOM_BORDER_INLINE_START]         = {"border-inline-start", 19, KEYWORD_COLORS | KEYWORD_PROPERTY},
+    [ATOM_BORDER_INLINE_START_COLOR]   = {"border-inline-start-color", 25, KEYWORD_COLORS | KEYWORD_PROPERTY},
+    [ATOM_BORDER_INLINE_START_STYLE]   = {"border-inline-start-style", 25, KEYWORD_PROPERTY},
+    [ATOM_BORDER_INLINE_START_WIDTH]   = {"border-inline-start-width", 25, KEYWORD_PROPERTY},
+    [ATOM_BORDER_INLINE_STYLE]         = {"border-inline-style", 19, KEYWORD_PROPERTY},
+    [ATOM_BORDER_INLINE_WIDTH]         = {"border-inline-width", 19, KEYWORD_PROPERTY},
+    [ATOM_BORDER_LEFT]                 = {"border-left", 11, KEYWORD_COLORS | KEYWORD_PROPERTY},
+    [ATOM_BORDER_LEFT_COLOR]           = {"border-left-color", 17, KEYWORD_COLORS | KEYWORD_PROPERTY},
+    [ATOM_BORDER_LEFT_STYLE]           = {"border-left-style", 17, KEYWORD_PROPERTY},
+    [ATOM_BORDER_LEFT_WIDTH]           = {"border-left-width", 17, KEYWORD_PROPERTY},
+    [ATOM_BORDER_RADIUS]               = {"border-radius", 13, KEYWORD_PROPERTY},
+    [ATOM_BORDER_RIGHT]                = {"border-right", 12, KEYWORD_COLORS | KEYWORD_PROPERTY},
+    [ATOM_BORDER_RIGHT_COLOR]          = {"border-right-color", 18, KEYWORD_COLORS | KEYWORD_PROPERTY},
+    [ATOM_BORDER_RIGHT_STYLE]          = {"border-right-style", 18, KEYWORD_PROPERTY},
+    [ATOM_BORDER_RIGHT_WIDTH]          = {"border-right-width", 18, KEYWORD_PROPERTY},
+    [ATOM_BORDER_SPACING]              = {"border-spacing", 14, KEYWORD_PROPERTY},
+    [ATOM_BORDER_START_END_RADIUS]     = {"border-start-end-radius", 23, KEYWORD_PROPERTY},
+    [ATOM_BORDER_START_START_RADIUS]   = {"border-start-start-radius", 25, KEYWORD_PROPERTY},
+    [ATOM_BORDER_STYLE]                = {"border-style", 12, KEYWORD_PROPERTY},
+    [ATOM_BORDER_TOP]                  = {"border-top", 10, KEYWORD_COLORS | KEYWORD_PROPERTY},
+    [ATOM_BORDER_TOP_COLOR]            = {"border-top-color", 16, KEYWORD_COLORS | KEYWORD_PROPERTY},
+    [ATOM_BORDER_TOP_LEFT_RADIUS]      = {"border-top-left-radius", 22, KEYWORD_PROPERTY},
+    [ATOM_BORDER_TOP_RIGHT_RADIUS]     = {"border-top-right-radius", 23, KEYWORD_PROPERTY},
+    [ATOM_BORDER_TOP_STYLE]            = {"border-top-style", 16, KEYWORD_PROPERTY},
+    [ATOM_BORDER_TOP_WIDTH]            = {"border-top-width", 16, KEYWORD_PROPERTY},
+    [ATOM_BORDER_WIDTH]                = {"border-width", 12, KEYWORD_PROPERTY},
+    [ATOM_BOTTOM]                      = {"bottom", 6, KEYWORD_PROPERTY},
+    [ATOM_BOX_DECORATION_BREAK]        = {"box-decoration-break", 20, KEYWORD_PROPERTY},
+    [ATOM_BOX_SHADOW]                  = {"box-shadow", 10, KEYWORD_COLORS | KEYWORD_PROPERTY},
+    [ATOM_BOX_SIZING]                  = {"box-sizing", 10, KEYWORD_PROPERTY},
+    [ATOM_BREAK_AFTER]                 = {"break-after", 11, KEYWORD_PROPERTY},
+    [ATOM_BREAK_BEFORE]                = {"break-before", 12, KEYWORD_PROPERTY},
+    [ATOM_BREAK_INSIDE]                = {"break-inside", 12, KEYWORD_PROPERTY},
+    [ATOM_CALC]                        = {"calc", 4, KEYWORD_FUNCTION},
+    [ATOM_CAP]                         = {"cap", 3, KEYWORD_LENGTH | KEYWORD_UNIT},
+    [ATOM_CAPTION_SIDE]                = {"caption-side", 12, KEYWORD_PROPERTY},
+    [ATOM_CARET_COLOR]                 = {"caret-color", 11, KEYWORD_COLORS | KEYWORD_PROPERTY},
+    [ATOM_CH]                          = {"ch", 2, KEYWORD_LENGTH | KEYWORD_UNIT},
+    [ATOM_CHARSET]                     = {"charset", 7, KEYWORD_AT_RULE},
+    [ATOM_CHECKED]                     = {"checked", 7, KEYWORD_PSEUDO_CLASS},
+    [ATOM_CLAMP]                       = {"clamp", 5, KEYWORD_FUNCTION},
+    [ATOM_CLEAR]                       = {"clear", 5, KEYWORD_PROPERTY},
+    [ATOM_CLIP]                        = {"clip", 4, KEYWORD_PROPERTY},
+    [ATOM_CLIP_PATH]                   = {"clip-path", 9, KEYWORD_PROPERTY},
+    [ATOM_CM]                          = {"cm", 2, KEYWORD_LENGTH | KEYWORD_UNIT},
+    [ATOM_COLOR]                       = {"color", 5, KEYWORD_COLORS | KEYWORD_PROPERTY},
+    [ATOM_COLOR_MIX]                   = {"color-mix", 9, KEYWORD_FUNCTION},
+    [ATOM_COLOR_SCHEME]                = {"color-scheme", 12, KEYWORD_PROPERTY},
+    [ATOM_COLUMN_COUNT]                = {"column-count", 12, KEYWORD_PROPERTY},
+    [ATOM_COLUMN_FILL]                 = {"column-fill", 11, KEYWORD_PROPERTY},
+    [ATOM_COLUMN_GAP]                  = {"column-gap", 10, KEYWORD_PROPERTY},
+    [ATOM_COLUMN_RULE]                 = {"column-rule", 11, KEYWORD_COLORS | KEYWORD_PROPERTY},
+    [ATOM_COLUMN_RULE_COLOR]           = {"column-rule-color", 17, KEYWORD_COLORS | KEYWORD_PROPERTY},
+    [ATOM_COLUMN_RULE_STYLE]           = {"column-rule-style", 17, KEYWORD_PROPERTY},
+    [ATOM_COLUMN_RULE_WIDTH]           = {"column-rule-width", 17, KEYWORD_PROPERTY},
+    [ATOM_COLUMN_SPAN]                 = {"column-span", 11, KEYWORD_PROPERTY},
+    [ATOM_COLUMN_WIDTH]                = {"column-width", 12, KEYWORD_PROPERTY},
+    [ATOM_COLUMNS]                     = {"columns", 7, KEYWORD_PROPERTY},
+    [ATOM_CONIC_GRADIENT]              = {"conic-gradient", 14, KEYWORD_FUNCTION},
+    [ATOM_CONTAIN]                     = {"contain", 7, KEYWORD_PROPERTY},
+    [ATOM_CONTAINER]                   = {"container", 9, KEYWORD_AT_RULE | KEYWORD_PROPERTY},
+    [ATOM_CONTAINER_NAME]              = {"container-name", 14, KEYWORD_PROPERTY},
+    [ATOM_CONTAINER_TYPE]              = {"container-type", 14, KEYWORD_PROPERTY},
+    [ATOM_CONTENT]                     = {"content", 7, KEYWORD_PROPERTY},
+    [ATOM_CONTENT_VISIBILITY]          = {"content-visibility", 18, KEYWORD_PROPERTY},
+    [ATOM_COUNTER]                     = {"counter", 7, KEYWORD_FUNCTION},
+    [ATOM_COUNTER_INCREMENT]           = {"counter-increment", 17, KEYWORD_PROPERTY},
+    [ATOM_COUNTER_RESET]               = {"counter-reset", 13, KEYWORD_PROPERTY},
+    [ATOM_COUNTER_SET]                 = {"counter-set", 11, KEYWORD_PROPERTY},
+    [ATOM_COUNTER_STYLE]               = {"counter-style", 13, KEYWORD_AT_RULE},
+    [ATOM_CQB]                         = {"cqb", 3, KEYWORD_LENGTH | KEYWORD_UNIT},
+    [ATOM_CQH]                         = {"cqh", 3, KEYWORD_LENGTH | KEYWORD_UNIT},
+    [ATOM_CQI]                         = {"cqi", 3, KEYWORD_LENGTH | KEYWORD_UNIT},
+    [ATOM_CQMAX]                       = {"cqmax", 5, KEYWORD_LENGTH | KEYWORD_UNIT},
+    [ATOM_CQMIN]                       = {"cqmin", 5, KEYWORD_LENGTH | KEYWORD_UNIT},
+    [ATOM_CQW]                         = {"cqw", 3, KEYWORD_LENGTH | KEYWORD_UNIT},
+    [ATOM_CURRENTCOLOR]                = {"currentcolor", 12, KEYWORD_VALUE},
+    [ATOM_CURSOR]                      = {"cursor", 6, KEYWORD_PROPERTY},
+    [ATOM_DEFAULT]                     = {"default", 7, KEYWORD_PSEUDO_CLASS},
+    [ATOM_DEFINED]                     = {"defined", 7, KEYWORD_PSEUDO_CLASS},
+    [ATOM_DEG]                         = {"deg", 3, KEYWORD_UNIT},
+    [ATOM_DIRECTION]                   = {"direction", 9, KEYWORD_PROPERTY},
+    [ATOM_DISABLED]                    = {"disabled", 8, KEYWORD_PSEUDO_CLASS},
+    [ATOM_DISPLAY]                     = {"display", 7, KEYWORD_PROPERTY},
+    [ATOM_DOCUMENT]                    = {"document", 8, KEYWORD_AT_RULE},
+    [ATOM_DPCM]                        = {"dpcm", 4, KEYWORD_UNIT},
+    [ATOM_DPI]                         = {"dpi", 3, KEYWORD_UNIT},
+    [ATOM_DPPX]                        = {"dppx", 4, KEYWORD_UNIT},
+    [ATOM_DROP_SHADOW]                 = {"drop-shadow", 11, KEYWORD_FUNCTION},
+    [ATOM_DVH]                         = {"dvh", 3, KEYWORD_LENGTH | KEYWORD_UNIT},
+    [ATOM_DVW]                         = {"dvw", 3, KEYWORD_LENGTH | KEYWORD_UNIT},
+    [ATOM_EM]                          = {"em", 2, KEYWORD_LENGTH | KEYWORD_UNIT},
+    [ATOM_EMPTY]                       = {"empty", 5, KEYWORD_PSEUDO_CLASS},
+    [ATOM_EMPTY_CELLS]                 = {"empty-cells", 11, KEYWORD_PROPERTY},
+    [ATOM_ENABLED]                     = {"enabled", 7, KEYWORD_PSEUDO_CLASS},
+    [ATOM_ENV]                         = {"env", 3, KEYWORD_FUNCTION},
+    [ATOM_EX]                          = {"ex", 2, KEYWORD_LENGTH | KEYWORD_UNIT},
+    [ATOM_FILL]                        = {"fill", 4, KEYWORD_COLORS | KEYWORD_PROPERTY},
+    [ATOM_FILL_OPACITY]                = {"fill-opacity", 12, KEYWORD_PROPERTY},
+    [ATOM_FILL_RULE]                   = {"fill-rule", 9, KEYWORD_PROPERTY},
+    [ATOM_FILTER]                      = {"filter", 6, KEYWORD_PROPERTY},
+    [ATOM_FIRST]                       = {"first", 5, KEYWORD_PSEUDO_CLASS},
+    [ATOM_FIRST_CHILD]                 = {"first-child", 11, KEYWORD_PSEUDO_CLASS},
+    [ATOM_FIRST_OF_TYPE]               = {"first-of-type", 13, KEYWORD_PSEUDO_CLASS},
+    [ATOM_FLEX]                        = {"flex", 4, KEYWORD_PROPERTY},
+    [ATOM_FLEX_BASIS]                  = {"flex-basis", 10, KEYWORD_PROPERTY},
+    [ATOM_FLEX_DIRECTION]              = {"flex-direction", 14, KEYWORD_PROPERTY},
+    [ATOM_FLEX_FLOW]                   = {"flex-flow", 9, KEYWORD_PROPERTY},
+    [ATOM_FLEX_GROW]                   = {"flex-grow", 9, KEYWORD_PROPERTY},
+    [ATOM_FLEX_SHRINK]                 = {"flex-shrink", 11, KEYWORD_PROPERTY},
+    [ATOM_FLEX_WRAP]                   = {"flex-wrap", 9, KEYWORD_PROPERTY},
+    [ATOM_FLOAT]                       = {"float", 5, KEYWORD_PROPERTY},
+    [ATOM_FLOOD_COLOR]                 = {"flood-color", 11, KEYWORD_COLORS | KEYWORD_PROPERTY},
+    [ATOM_FLOOD_OPACITY]               = {"flood-opacity", 13, KEYWORD_PROPERTY},
+    [ATOM_FOCUS]                       = {"focus", 5, KEYWORD_PSEUDO_CLASS},
+    [ATOM_FOCUS_VISIBLE]               = {"focus-visible", 13, KEYWORD_PSEUDO_CLASS},
+    [ATOM_FOCUS_WITHIN]                = {"focus-within", 12, KEYWORD_PSEUDO_CLASS},
+    [ATOM_FONT]                        = {"font", 4, KEYWORD_PROPERTY},
+    [ATOM_FONT_DISPLAY]                = {"font-display", 12, KEYWORD_PROPERTY},
+    [ATOM_FONT_FACE]                   = {"font-face", 9, KEYWORD_AT_RULE},
+    [ATOM_FONT_FAMILY]                 = {"font-family", 11, KEYWORD_PROPERTY},
+    [ATOM_FONT_FEATURE_SETTINGS]       = {"font-feature-settings", 21, KEYWORD_PROPERTY},
+    [ATOM_FONT_FEATURE_VALUES]         = {"font-feature-values", 19, KEYWORD_AT_RULE},
+    [ATOM_FONT_KERNING]                = {"font-kerning", 12, KEYWORD_PROPERTY},
+    [ATOM_FONT_OPTICAL_SIZING]         = {"font-optical-sizing", 19, KEYWORD_PROPERTY},
+    [ATOM_FONT_PALETTE_VALUES]         = {"font-palette-values", 19, KEYWORD_AT_RULE},
+    [ATOM_FONT_SIZE]                   = {"font-size", 9, KEYWORD_PROPERTY},
+    [ATOM_FONT_SIZE_ADJUST]            = {"font-size-adjust", 16, KEYWORD_PROPERTY},
+    [ATOM_FONT_STRETCH]                = {"font-stretch", 12, KEYWORD_PROPERTY},
+    [ATOM_FONT_STYLE]                  = {"font-style", 10, KEYWORD_PROPERTY},
+    [ATOM_FONT_SYNTHESIS]              = {"font-synthesis", 14, KEYWORD_PROPERTY},
+    [ATOM_FONT_VARIANT]                = {"font-variant", 12, KEYWORD_PROPERTY},
+    [ATOM_FONT_VARIANT_CAPS]           = {"font-variant-caps", 17, KEYWORD_PROPERTY},
+    [ATOM_FONT_VARIANT_EAST_ASIAN]     = {"font-variant-east-asian", 23, KEYWORD_PROPERTY},
+    [ATOM_FONT_VARIANT_LIGATURES]      = {"font-variant-ligatures", 22, KEYWORD_PROPERTY},
+    [ATOM_FONT_VARIANT_NUMERIC]        = {"font-variant-numeric", 20, KEYWORD_PROPERTY},
+    [ATOM_FONT_VARIATION_SETTINGS]     = {"font-variation-settings", 23, KEYWORD_PROPERTY},
+    [ATOM_FONT_WEIGHT]                 = {"font-weight", 11, KEYWORD_PROPERTY},
+    [ATOM_FR]                          = {"fr", 2, KEYWORD_UNIT},
+    [ATOM_FULLSCREEN]                  = {"fullscreen", 10, KEYWORD_PSEUDO_CLASS},
+    [ATOM_GAP]                         = {"gap", 3, KEYWORD_PROPERTY},
+    [ATOM_GRAD]                        = {"grad", 4, KEYWORD_UNIT},
+    [ATOM_GRID]                        = {"grid", 4, KEYWORD_PROPERTY},
+    [ATOM_GRID_AREA]                   = {"grid-area", 9, KEYWORD_PROPERTY},
+    [ATOM_GRID_AUTO_COLUMNS]           = {"grid-auto-columns", 17, KEYWORD_PROPERTY},
+    [ATOM_GRID_AUTO_FLOW]              = {"grid-auto-flow", 14, KEYWORD_PROPERTY},
+    [ATOM_GRID_AUTO_ROWS]              = {"grid-auto-rows", 14, KEYWORD_PROPERTY},
+    [ATOM_GRID_COLUMN]                 = {"grid-column", 11, KEYWORD_PROPERTY},
+    [ATOM_GRID_COLUMN_END]             = {"grid-column-end", 15, KEYWORD_PROPERTY},
+    [ATOM_GRID_COLUMN_GAP]             = {"grid-column-gap", 15, KEYWORD_PROPERTY},
+    [ATOM_GRID_COLUMN_START]           = {"grid-column-start", 17, KEYWORD_PROPERTY},
+    [ATOM_GRID_GAP]                    = {"grid-gap", 8, KEYWORD_PROPERTY},
+    [ATOM_GRID_ROW]                    = {"grid-row", 8, KEYWORD_PROPERTY},
+    [ATOM_GRID_ROW_END]                = {"grid-row-end", 12, KEYWORD_PROPERTY},
+    [ATOM_GRID_ROW_GAP]                = {"grid-row-gap", 12, KEYWORD_PROPERTY},
+    [ATOM_GRID_ROW_START]              = {"grid-row-start", 14, KEYWORD_PROPERTY},
+    [ATOM_GRID_TEMPLATE]               = {"grid-template", 13, KEYWORD_PROPERTY},
+    [ATOM_GRID_TEMPLATE_AREAS]         = {"grid-template-areas", 19, KEYWORD_PROPERTY},
+    [ATOM_GRID_TEMPLATE_COLUMNS]       = {"grid-template-columns", 21, KEYWORD_PROPERTY},
+    [ATOM_GRID_TEMPLATE_ROWS]          = {"grid-template-rows", 18, KEYWORD_PROPERTY},
+    [ATOM_HAS]                         = {"has", 3, KEYWORD_PSEUDO_CLASS},
+    [ATOM_HEIGHT]                      = {"height", 6, KEYWORD_PROPERTY},
+    [ATOM_HOST]                        = {"host", 4, KEYWORD_PSEUDO_CLASS},
+    [ATOM_HOVER]                       = {"hover", 5, KEYWORD_PSEUDO_CLASS},
+    [ATOM_HSL]                         = {"hsl", 3, KEYWORD_FUNCTION},
+    [ATOM_HSLA]                        = {"hsla", 4, KEYWORD_FUNCTION},
+    [ATOM_HYPHENS]                     = {"hyphens", 7, KEYWORD_PROPERTY},
+    [ATOM_HZ]                          = {"hz", 2, KEYWORD_UNIT},
+    [ATOM_IC]                          = {"ic", 2, KEYWORD_LENGTH | KEYWORD_UNIT},
+    [ATOM_IMAGE_RENDERING]             = {"image-rendering", 15, KEYWORD_PROPERTY},
+    [ATOM_IMPORT]                      = {"import", 6, KEYWORD_AT_RULE},
+    [ATOM_IN]                          = {"in", 2, KEYWORD_LENGTH | KEYWORD_UNIT},
+    [ATOM_IN_RANGE]                    = {"in-range", 8, KEYWORD_PSEUDO_CLASS},
+    [ATOM_INDETERMINATE]               = {"indeterminate", 13, KEYWORD_PSEUDO_CLASS},
+    [ATOM_INHERIT]                     = {"inherit", 7, KEYWORD_VALUE},
+    [ATOM_INITIAL]                     = {"initial", 7, KEYWORD_VALUE},
+    [ATOM_INLINE_SIZE]                 = {"inline-size", 11, KEYWORD_PROPERTY},
+    [ATOM_INSET]                       = {"inset", 5, KEYWORD_PROPERTY},
+    [ATOM_INSET_BLOCK]                 = {"inset-block", 11, KEYWORD_PROPERTY},
+    [ATOM_INSET_BLOCK_END]             = {"inset-block-end", 15, KEYWORD_PROPERTY},
+    [ATOM_INSET_BLOCK_START]           = {"inset-block-start", 17, KEYWORD_PROPERTY},
+    [ATOM_INSET_INLINE]                = {"inset-inline", 12, KEYWORD_PROPERTY},
+    [ATOM_INSET_INLINE_END]            = {"inset-inline-end", 16, KEYWORD_PROPERTY},
+    [ATOM_INSET_INLINE_START]          = {"inset-inline-start", 18, KEYWORD_PROPERTY},
+    [ATOM_INVALID]                     = {"invalid", 7, KEYWORD_PSEUDO_CLASS},
+    [ATOM_IS]                          = {"is", 2, KEYWORD_PSEUDO_CLASS},
+    [ATOM_ISOLATION]                   = {"isolation", 9, KEYWORD_PROPERTY},
+    [ATOM_JUSTIFY_CONTENT]             = {"justify-content", 15, KEYWORD_PROPERTY},
+    [ATOM_JUSTIFY_ITEMS]               = {"justify-items", 13, KEYWORD_PROPERTY},
+    [ATOM_JUSTIFY_SELF]                = {"justify-self", 12, KEYWORD_PROPERTY},
+    [ATOM_KEYFRAMES]                   = {"keyframes", 9, KEYWORD_AT_RULE},
+    [ATOM_KHZ]                         = {"khz", 3, KEYWORD_UNIT},
+    [ATOM_LANG]                        = {"lang", 4, KEYWORD_PSEUDO_CLASS},
+    [ATOM_LAST_CHILD]                  = {"last-child", 10, KEYWORD_PSEUDO_CLASS},
+    [ATOM_LAST_OF_TYPE]                = {"last-of-type", 12, KEYWORD_PSEUDO_CLASS},
+    [ATOM_LAYER]                       = {"layer", 5, KEYWORD_AT_RULE},
+    [ATOM_LEFT]                        = {"left", 4, KEYWORD_PROPERTY | KEYWORD_PSEUDO_CLASS},
+    [ATOM_LETTER_SPACING]              = {"letter-spacing", 14, KEYWORD_PROPERTY},
+    [ATOM_LH]                          = {"lh", 2, KEYWORD_LENGTH | KEYWORD_UNIT},
+    [ATOM_LIGHT_DARK]                  = {"light-dark", 10, KEYWORD_FUNCTION},
+    [ATOM_LIGHTING_COLOR]              = {"lighting-color", 14, KEYWORD_COLORS | KEYWORD_PROPERTY},
+    [ATOM_LINE_BREAK]                  = {"line-break", 10, KEYWORD_PROPERTY},
+    [ATOM_LINE_HEIGHT]                 = {"line-height", 11, KEYWORD_PROPERTY},
+    [ATOM_LINEAR_GRADIENT]             = {"linear-gradient", 15, KEYWORD_FUNCTION},
+    [ATOM_LINK]                        = {"link", 4, KEYWORD_PSEUDO_CLASS},
+    [ATOM_LIST_STYLE]                  = {"list-style", 10, KEYWORD_PROPERTY},
+    [ATOM_LIST_STYLE_IMAGE]            = {"list-style-image", 16, KEYWORD_PROPERTY},
+    [ATOM_LIST_STYLE_POSITION]         = {"list-style-position", 19, KEYWORD_PROPERTY},
+    [ATOM_LIST_STYLE_TYPE]             = {"list-style-type", 15, KEYWORD_PROPERTY},
+    [ATOM_LVH]                         = {"lvh", 3, KEYWORD_LENGTH | KEYWORD_UNIT},
+    [ATOM_LVW]                         = {"lvw", 3, KEYWORD_LENGTH | KEYWORD_UNIT},
+    [ATOM_MARGIN]                      = {"margin", 6, KEYWORD_PROPERTY},
+    [ATOM_MARGIN_BLOCK]                = {"margin-block", 12, KEYWORD_PROPERTY},
+    [ATOM_MARGIN_BLOCK_END]            = {"margin-block-end", 16, KEYWORD_PROPERTY},
+    [ATOM_MARGIN_BLOCK_START]          = {"margin-block-start", 18, KEYWORD_PROPERTY},
+    [ATOM_MARGIN_BOTTOM]               = {"margin-bottom", 13, KEYWORD_PROPERTY},
+    [ATOM_MARGIN_INLINE]               = {"margin-inline", 13, KEYWORD_PROPERTY},
+    [ATOM_MARGIN_INLINE_END]           = {"margin-inline-end", 17, KEYWORD_PROPERTY},
+    [ATOM_MARGIN_INLINE_START]         = {"margin-inline-start", 19, KEYWORD_PROPERTY},
+    [ATOM_MARGIN_LEFT]                 = {"margin-left", 11, KEYWORD_PROPERTY},
+    [ATOM_MARGIN_RIGHT]                = {"margin-right", 12, KEYWORD_PROPERTY},
+    [ATOM_MARGIN_TOP]                  = {"margin-top", 10, KEYWORD_PROPERTY},
+    [ATOM_MARKER]                      = {"marker", 6, KEYWORD_PROPERTY},
+    [ATOM_MASK]                        = {"mask", 4, KEYWORD_PROPERTY},
+    [ATOM_MASK_IMAGE]                  = {"mask-image", 10, KEYWORD_PROPERTY},
+    [ATOM_MASK_POSITION]               = {"mask-position", 13, KEYWORD_PROPERTY},
+    [ATOM_MASK_REPEAT]                 = {"mask-repeat", 11, KEYWORD_PROPERTY},
+    [ATOM_MASK_SIZE]                   = {"mask-size", 9, KEYWORD_PROPERTY},
+    [ATOM_MAX]                         = {"max", 3, KEYWORD_FUNCTION},
+    [ATOM_MAX_BLOCK_SIZE]              = {"max-block-size", 14, KEYWORD_PROPERTY},
+    [ATOM_MAX_HEIGHT]                  = {"max-height", 10, KEYWORD_PROPERTY},
+    [ATOM_MAX_INLINE_SIZE]             = {"max-inline-size", 15, KEYWORD_PROPERTY},
+    [ATOM_MAX_WIDTH]                   = {"max-width", 9, KEYWORD_PROPERTY},
+    [ATOM_MEDIA]                       = {"media", 5, KEYWORD_AT_RULE},
+    [ATOM_MIN]                         = {"min", 3, KEYWORD_FUNCTION},
+    [ATOM_MIN_BLOCK_SIZE]              = {"min-block-size", 14, KEYWORD_PROPERTY},
+    [ATOM_MIN_HEIGHT]                  = {"min-height", 10, KEYWORD_PROPERTY},
+    [ATOM_MIN_INLINE_SIZE]             = {"min-inline-size", 15, KEYWORD_PROPERTY},
+    [ATOM_MIN_WIDTH]                   = {"min-width", 9, KEYWORD_PROPERTY},
+    [ATOM_MIX_BLEND_MODE]              = {"mix-blend-mode", 14, KEYWORD_PROPERTY},
+    [ATOM_MM]                          = {"mm", 2, KEYWORD_LENGTH | KEYWORD_UNIT},
+    [ATOM_MS]                          = {"ms", 2, KEYWORD_UNIT},
+    [ATOM_NAMESPACE]                   = {"namespace", 9, KEYWORD_AT_RULE},
+    [ATOM_NONE]                        = {"none", 4, KEYWORD_VALUE},
+    [ATOM_NORMAL]                      = {"normal", 6, KEYWORD_VALUE},
+    [ATOM_NOT]                         = {"not", 3, KEYWORD_PSEUDO_CLASS},
+    [ATOM_NTH_CHILD]                   = {"nth-child", 9, KEYWORD_PSEUDO_CLASS},
+    [ATOM_NTH_LAST_CHILD]              = {"nth-last-child", 14, KEYWORD_PSEUDO_CLASS},
+    [ATOM_NTH_LAST_OF_TYPE]            = {"nth-last-of-type", 16, KEYWORD_PSEUDO_CLASS},
+    [ATOM_NTH_OF_TYPE]                 = {"nth-of-type", 11, KEYWORD_PSEUDO_CLASS},
+    [ATOM_OBJECT_FIT]                  = {"object-fit", 10, KEYWORD_PROPERTY},
+    [ATOM_OBJECT_POSITION]             = {"object-position", 15, KEYWORD_PROPERTY},
+    [ATOM_OFFSET]                      = {"offset", 6, KEYWORD_PROPERTY},
+    [ATOM_ONLY_CHILD]                  = {"only-child", 10, KEYWORD_PSEUDO_CLASS},
+    [ATOM_ONLY_OF_TYPE]                = {"only-of-type", 12, KEYWORD_PSEUDO_CLASS},
+    [ATOM_OPACITY]                     = {"opacity", 7, KEYWORD_PROPERTY},
+    [ATOM_OPTIONAL]                    = {"optional", 8, KEYWORD_PSEUDO_CLASS},
+    [ATOM_ORDER]                       = {"order", 5, KEYWORD_PROPERTY},
+    [ATOM_ORPHANS]                     = {"orphans", 7, KEYWORD_PROPERTY},
+    [ATOM_OUT_OF_RANGE]                = {"out-of-range", 12, KEYWORD_PSEUDO_CLASS},
+    [ATOM_OUTLINE]                     = {"outline", 7, KEYWORD_COLORS | KEYWORD_PROPERTY},
+    [ATOM_OUTLINE_COLOR]               = {"outline-color", 13, KEYWORD_COLORS | KEYWORD_PROPERTY},
+    [ATOM_OUTLINE_OFFSET]              = {"outline-offset", 14, KEYWORD_PROPERTY},
+    [ATOM_OUTLINE_STYLE]               = {"outline-style", 13, KEYWORD_PROPERTY},
+    [ATOM_OUTLINE_WIDTH]               = {"outline-width", 13, KEYWORD_PROPERTY},
+    [ATOM_OVERFLOW]                    = {"overflow", 8, KEYWORD_PROPERTY},
+    [ATOM_OVERFLOW_ANCHOR]             = {"overflow-anchor", 15, KEYWORD_PROPERTY},
+    [ATOM_OVERFLOW_WRAP]               = {"overflow-wrap", 13, KEYWORD_PROPERTY},
+    [ATOM_OVERFLOW_X]                  = {"overflow-x", 10, KEYWORD_PROPERTY},
+    [ATOM_OVERFLOW_Y]                  = {"overflow-y", 10, KEYWORD_PROPERTY},
+    [ATOM_OVERSCROLL_BEHAVIOR]         = {"overscroll-behavior", 19, KEYWORD_PROPERTY},
+    [ATOM_OVERSCROLL_BEHAVIOR_X]       = {"overscroll-behavior-x", 21, KEYWORD_PROPERTY},
+    [ATOM_OVERSCROLL_BEHAVIOR_Y]       = {"overscroll-behavior-y", 21, KEYWORD_PROPERTY},
+    [ATOM_PADDING]                     = {"padding", 7, KEYWORD_PROPERTY},
+    [ATOM_PADDING_BLOCK]               = {"padding-block", 13, KEYWORD_PROPERTY},
+    [ATOM_PADDING_BLOCK_END]           = {"padding-block-end", 17, KEYWORD_PROPERTY},
+    [ATOM_PADDING_BLOCK_START]         = {"padding-block-start", 19, KEYWORD_PROPERTY},
+    [ATOM_PADDING_BOTTOM]              = {"padding-bottom", 14, KEYWORD_PROPERTY},
+    [ATOM_PADDING_INLINE]              = {"padding-inline", 14, KEYWORD_PROPERTY},
+    [ATOM_PADDING_INLINE_END]          = {"padding-inline-end", 18, KEYWORD_PROPERTY},
+    [ATOM_PADDING_INLINE_START]        = {"padding-inline-start", 20, KEYWORD_PROPERTY},
+    [ATOM_PADDING_LEFT]                = {"padding-left", 12, KEYWORD_PROPERTY},
+    [ATOM_PADDING_RIGHT]               = {"padding-right", 13, KEYWORD_PROPERTY},
+    [ATOM_PADDING_TOP]                 = {"padding-top", 11, KEYWORD_PROPERTY},
+    [ATOM_PAGE]                        = {"page", 4, KEYWORD_AT_RULE | KEYWORD_PROPERTY},
+    [ATOM_PAGE_BREAK_AFTER]            = {"page-break-after", 16, KEYWORD_PROPERTY},
+    [ATOM_PAGE_BREAK_BEFORE]           = {"page-break-before", 17, KEYWORD_PROPERTY},
+    [ATOM_PAGE_BREAK_INSIDE]           = {"page-break-inside", 17, KEYWORD_PROPERTY},
+    [ATOM_PAINT_ORDER]                 = {"paint-order", 11, KEYWORD_PROPERTY},
+    [ATOM_PC]                          = {"pc", 2, KEYWORD_LENGTH | KEYWORD_UNIT},
+    [ATOM_PERSPECTIVE]                 = {"perspective", 11, KEYWORD_PROPERTY},
+    [ATOM_PERSPECTIVE_ORIGIN]          = {"perspective-origin", 18, KEYWORD_PROPERTY},
+    [ATOM_PLACE_CONTENT]               = {"place-content", 13, KEYWORD_PROPERTY},
+    [ATOM_PLACE_ITEMS]                 = {"place-items", 11, KEYWORD_PROPERTY},
+    [ATOM_PLACE_SELF]                  = {"place-self", 10, KEYWORD_PROPERTY},
+    [ATOM_PLACEHOLDER_SHOWN]           = {"placeholder-shown", 17, KEYWORD_PSEUDO_CLASS},
+    [ATOM_POINTER_EVENTS]              = {"pointer-events", 14, KEYWORD_PROPERTY},
+    [ATOM_POSITION]                    = {"position", 8, KEYWORD_PROPERTY},
+    [ATOM_PRINT_COLOR_ADJUST]          = {"print-color-adjust", 18, KEYWORD_PROPERTY},
+    [ATOM_PROPERTY]                    = {"property", 8, KEYWORD_AT_RULE},
+    [ATOM_PT]                          = {"pt", 2, KEYWORD_LENGTH | KEYWORD_UNIT},
+    [ATOM_PX]                          = {"px", 2, KEYWORD_LENGTH | KEYWORD_UNIT},
+    [ATOM_Q]                           = {"q", 1, KEYWORD_LENGTH | KEYWORD_UNIT},
+    [ATOM_QUOTES]                      = {"quotes", 6, KEYWORD_PROPERTY},
+    [ATOM_RAD]                         = {"rad", 3, KEYWORD_UNIT},
+    [ATOM_RADIAL_GRADIENT]             = {"radial-gradient", 15, KEYWORD_FUNCTION},
+    [ATOM_READ_ONLY]                   = {"read-only", 9, KEYWORD_PSEUDO_CLASS},
+    [ATOM_READ_WRITE]                  = {"read-write", 10, KEYWORD_PSEUDO_CLASS},
+    [ATOM_REM]                         = {"rem", 3, KEYWORD_LENGTH | KEYWORD_UNIT},
+    [ATOM_REPEATING_CONIC_GRADIENT]    = {"repeating-conic-gradient", 24, KEYWORD_FUNCTION},
+    [ATOM_REPEATING_LINEAR_GRADIENT]   = {"repeating-linear-gradient", 25, KEYWORD_FUNCTION},
+    [ATOM_REPEATING_RADIAL_GRADIENT]   = {"repeating-radial-gradient", 25, KEYWORD_FUNCTION},
+    [ATOM_REQUIRED]                    = {"required", 8, KEYWORD_PSEUDO_CLASS},
+    [ATOM_RESIZE]                      = {"resize", 6, KEYWORD_PROPERTY},
+    [ATOM_REVERT]                      = {"revert", 6, KEYWORD_VALUE},
+    [ATOM_RGB]                         = {"rgb", 3, KEYWORD_FUNCTION},
+    [ATOM_RGBA]                        = {"rgba", 4, KEYWORD_FUNCTION},
+    [ATOM_RIGHT]                       = {"right", 5, KEYWORD_PROPERTY | KEYWORD_PSEUDO_CLASS},
+    [ATOM_RLH]                         = {"rlh", 3, KEYWORD_LENGTH | KEYWORD_UNIT},
+    [ATOM_ROOT]                        = {"root", 4, KEYWORD_PSEUDO_CLASS},
+    [ATOM_ROTATE]                      = {"rotate", 6, KEYWORD_PROPERTY},
+    [ATOM_ROW_GAP]                     = {"row-gap", 7, KEYWORD_PROPERTY},
+    [ATOM_S]                           = {"s", 1, KEYWORD_UNIT},
+    [ATOM_SCALE]                       = {"scale", 5, KEYWORD_PROPERTY},
+    [ATOM_SCOPE]                       = {"scope", 5, KEYWORD_AT_RULE | KEYWORD_PSEUDO_CLASS},
+    [ATOM_SCROLL_BEHAVIOR]             = {"scroll-behavior", 15, KEYWORD_PROPERTY},
+    [ATOM_SCROLL_MARGIN]               = {"scroll-margin", 13, KEYWORD_PROPERTY},
+    [ATOM_SCROLL_MARGIN_BLOCK]         = {"scroll-margin-block", 19, KEYWORD_PROPERTY},
+    [ATOM_SCROLL_MARGIN_BOTTOM]        = {"scroll-margin-bottom", 20, KEYWORD_PROPERTY},
+    [ATOM_SCROLL_MARGIN_INLINE]        = {"scroll-margin-inline", 20, KEYWORD_PROPERTY},
+    [ATOM_SCROLL_MARGIN_LEFT]          = {"scroll-margin-left", 18, KEYWORD_PROPERTY},
+    [ATOM_SCROLL_MARGIN_RIGHT]         = {"scroll-margin-right", 19, KEYWORD_PROPERTY},
+    [ATOM_SCROLL_MARGIN_TOP]           = {"scroll-margin-top", 17, KEYWORD_PROPERTY},
+    [ATOM_SCROLL_PADDING]              = {"scroll-padding", 14, KEYWORD_PROPERTY},
+    [ATOM_SCROLL_PADDING_BLOCK]        = {"scroll-padding-block", 20, KEYWORD_PROPERTY},
+    [ATOM_SCROLL_PADDING_BOTTOM]       = {"scroll-padding-bottom", 21, KEYWORD_PROPERTY},
+    [ATOM_SCROLL_PADDING_INLINE]       = {"scroll-padding-inline", 21, KEYWORD_PROPERTY},
+    [ATOM_SCROLL_PADDING_LEFT]         = {"scroll-padding-left", 19, KEYWORD_PROPERTY},
+    [ATOM_SCROLL_PADDING_RIGHT]        = {"scroll-padding-right", 20, KEYWORD_PROPERTY},
+    [ATOM_SCROLL_PADDING_TOP]          = {"scroll-padding-top", 18, KEYWORD_PROPERTY},
+    [ATOM_SCROLL_SNAP_ALIGN]           = {"scroll-snap-align", 17, KEYWORD_PROPERTY},
+    [ATOM_SCROLL_SNAP_STOP]            = {"scroll-snap-stop", 16, KEYWORD_PROPERTY},
+    [ATOM_SCROLL_SNAP_TYPE]            = {"scroll-snap-type", 16, KEYWORD_PROPERTY},
+    [ATOM_SCROLLBAR_COLOR]             = {"scrollbar-color", 15, KEYWORD_COLORS | KEYWORD_PROPERTY},
+    [ATOM_SCROLLBAR_GUTTER]            = {"scrollbar-gutter", 16, KEYWORD_PROPERTY},
+    [ATOM_SCROLLBAR_WIDTH]             = {"scrollbar-width", 15, KEYWORD_PROPERTY},
+    [ATOM_SHAPE_IMAGE_THRESHOLD]       = {"shape-image-threshold", 21, KEYWORD_PROPERTY},
+    [ATOM_SHAPE_MARGIN]                = {"shape-margin", 12, KEYWORD_PROPERTY},
+    [ATOM_SHAPE_OUTSIDE]               = {"shape-outside", 13, KEYWORD_PROPERTY},
+    [ATOM_SPEAK]                       = {"speak", 5, KEYWORD_PROPERTY},
+    [ATOM_SRC]                         = {"src", 3, KEYWORD_PROPERTY},
+    [ATOM_STARTING_STYLE]              = {"starting-style", 14, KEYWORD_AT_RULE},
+    [ATOM_STOP_COLOR]                  = {"stop-color", 10, KEYWORD_COLORS | KEYWORD_PROPERTY},
+    [ATOM_STOP_OPACITY]                = {"stop-opacity", 12, KEYWORD_PROPERTY},
+    [ATOM_STROKE]                      = {"stroke", 6, KEYWORD_COLORS | KEYWORD_PROPERTY},
+    [ATOM_STROKE_DASHARRAY]            = {"stroke-dasharray", 16, KEYWORD_PROPERTY},
+    [ATOM_STROKE_DASHOFFSET]           = {"stroke-dashoffset", 17, KEYWORD_PROPERTY},
+    [ATOM_STROKE_LINECAP]              = {"stroke-linecap", 14, KEYWORD_PROPERTY},
+    [ATOM_STROKE_LINEJOIN]             = {"stroke-linejoin", 15, KEYWORD_PROPERTY},
+    [ATOM_STROKE_MITERLIMIT]           = {"stroke-miterlimit", 17, KEYWORD_PROPERTY},
+    [ATOM_STROKE_OPACITY]              = {"stroke-opacity", 14, KEYWORD_PROPERTY},
+    [ATOM_STROKE_WIDTH]                = {"stroke-width", 12, KEYWORD_PROPERTY},
+    [ATOM_SUPPORTS]                    = {"supports", 8, KEYWORD_AT_RULE},
+    [ATOM_SVH]                         = {"svh", 3, KEYWORD_LENGTH | KEYWORD_UNIT},
+    [ATOM_SVW]                         = {"svw", 3, KEYWORD_LENGTH | KEYWORD_UNIT},
+    [ATOM_TAB_SIZE]                    = {"tab-size", 8, KEYWORD_PROPERTY},
+    [ATOM_TABLE_LAYOUT]                = {"table-layout", 12, KEYWORD_PROPERTY},
+    [ATOM_TARGET]                      = {"target", 6, KEYWORD_PSEUDO_CLASS},
+    [ATOM_TEXT_ALIGN]                  = {"text-align", 10, KEYWORD_PROPERTY},
+    [ATOM_TEXT_ALIGN_LAST]             = {"text-align-last", 15, KEYWORD_PROPERTY},
+    [ATOM_TEXT_COMBINE_UPRIGHT]        = {"text-combine-upright", 20, KEYWORD_PROPERTY},
+    [ATOM_TEXT_DECORATION]             = {"text-decoration", 15, KEYWORD_COLORS | KEYWORD_PROPERTY},
+    [ATOM_TEXT_DECORATION_COLOR]       = {"text-decoration-color", 21, KEYWORD_COLORS | KEYWORD_PROPERTY},
+    [ATOM_TEXT_DECORATION_LINE]        = {"text-decoration-line", 20, KEYWORD_PROPERTY},
+    [ATOM_TEXT_DECORATION_SKIP_INK]    = {"text-decoration-skip-ink", 24, KEYWORD_PROPERTY},
+    [ATOM_TEXT_DECORATION_STYLE]       = {"text-decoration-style", 21, KEYWORD_PROPERTY},
+    [ATOM_TEXT_DECORATION_THICKNESS]   = {"text-decoration-thickness", 25, KEYWORD_PROPERTY},
+    [ATOM_TEXT_EMPHASIS]               = {"text-emphasis", 13, KEYWORD_COLORS | KEYWORD_PROPERTY},
+    [ATOM_TEXT_EMPHASIS_COLOR]         = {"text-emphasis-color", 19, KEYWORD_COLORS | KEYWORD_PROPERTY},
+    [ATOM_TEXT_EMPHASIS_POSITION]      = {"text-emphasis-position", 22, KEYWORD_PROPERTY},
+    [ATOM_TEXT_EMPHASIS_STYLE]         = {"text-emphasis-style", 19, KEYWORD_PROPERTY},
+    [ATOM_TEXT_INDENT]                 = {"text-indent", 11, KEYWORD_PROPERTY},
+    [ATOM_TEXT_JUSTIFY]                = {"text-justify", 12, KEYWORD_PROPERTY},
+    [ATOM_TEXT_ORIENTATION]            = {"text-orientation", 16, KEYWORD_PROPERTY},
+    [ATOM_TEXT_OVERFLOW]               = {"text-overflow", 13, KEYWORD_PROPERTY},
+    [ATOM_TEXT_RENDERING]              = {"text-rendering", 14, KEYWORD_PROPERTY},
+    [ATOM_TEXT_SHADOW]                 = {"text-shadow", 11, KEYWORD_COLORS | KEYWORD_PROPERTY},
+    [ATOM_TEXT_SIZE_ADJUST]            = {"text-size-adjust", 16, KEYWORD_PROPERTY},
+    [ATOM_TEXT_TRANSFORM]              = {"text-transform", 14, KEYWORD_PROPERTY},
+    [ATOM_TEXT_UNDERLINE_OFFSET]       = {"text-underline-offset", 21, KEYWORD_PROPERTY},
+    [ATOM_TEXT_UNDERLINE_POSITION]     = {"text-underline-position", 23, KEYWORD_PROPERTY},
+    [ATOM_TEXT_WRAP]                   = {"text-wrap", 9, KEYWORD_PROPERTY},
+    [ATOM_TOP]                         = {"top", 3, KEYWORD_PROPERTY},
+    [ATOM_TOUCH_ACTION]                = {"touch-action", 12, KEYWORD_PROPERTY},
+    [ATOM_TRANSFORM]                   = {"transform", 9, KEYWORD_PROPERTY},
+    [ATOM_TRANSFORM_BOX]               = {"transform-box", 13, KEYWORD_PROPERTY},
+    [ATOM_TRANSFORM_ORIGIN]            = {"transform-origin", 16, KEYWORD_PROPERTY},
+    [ATOM_TRANSFORM_STYLE]             = {"transform-style", 15, KEYWORD_PROPERTY},
+    [ATOM_TRANSITION]                  = {"transition", 10, KEYWORD_PROPERTY},
+    [ATOM_TRANSITION_BEHAVIOR]         = {"transition-behavior", 19, KEYWORD_PROPERTY},
+    [ATOM_TRANSITION_DELAY]            = {"transition-delay", 16, KEYWORD_PROPERTY},
+    [ATOM_TRANSITION_DURATION]         = {"transition-duration", 19, KEYWORD_PROPERTY},
+    [ATOM_TRANSITION_PROPERTY]         = {"transition-property", 19, KEYWORD_PROPERTY},
+    [ATOM_TRANSITION_TIMING_FUNCTION]  = {"transition-timing-function", 26, KEYWORD_PROPERTY},
+    [ATOM_TRANSLATE]                   = {"translate", 9, KEYWORD_PROPERTY},
+    [ATOM_TRANSPARENT]                 = {"transparent", 11, KEYWORD_VALUE},
+    [ATOM_TURN]                        = {"turn", 4, KEYWORD_UNIT},
+    [ATOM_UNICODE_BIDI]                = {"unicode-bidi", 12, KEYWORD_PROPERTY},
+    [ATOM_UNICODE_RANGE]               = {"unicode-range", 13, KEYWORD_PROPERTY},
+    [ATOM_UNSET]                       = {"unset", 5, KEYWORD_VALUE},
+    [ATOM_URL]                         = {"url", 3, KEYWORD_FUNCTION},
+    [ATOM_USER_SELECT]                 = {"user-select", 11, KEYWORD_PROPERTY},
+    [ATOM_VALID]                       = {"valid", 5, KEYWORD_PSEUDO_CLASS},
+    [ATOM_VAR]                         = {"var", 3, KEYWORD_FUNCTION},
+    [ATOM_VB]                          = {"vb", 2, KEYWORD_LENGTH | KEYWORD_UNIT},
+    [ATOM_VERTICAL_ALIGN]              = {"vertical-align", 14, KEYWORD_PROPERTY},
+    [ATOM_VH]                          = {"vh", 2, KEYWORD_LENGTH | KEYWORD_UNIT},
+    [ATOM_VI]                          = {"vi", 2, KEYWORD_LENGTH | KEYWORD_UNIT},
+    [ATOM_VIEWPORT]                    = {"viewport", 8, KEYWORD_AT_RULE},
+    [ATOM_VISIBILITY]                  = {"visibility", 10, KEYWORD_PROPERTY},
+    [ATOM_VISITED]                     = {"visited", 7, KEYWORD_PSEUDO_CLASS},
+    [ATOM_VMAX]                        = {"vmax", 4, KEYWORD_LENGTH | KEYWORD_UNIT},
+    [ATOM_VMIN]                        = {"vmin", 4, KEYWORD_LENGTH | KEYWORD_UNIT},
+    [ATOM_VW]                          = {"vw", 2, KEYWORD_LENGTH | KEYWORD_UNIT},
+    [ATOM_WHERE]                       = {"where", 5, KEYWORD_PSEUDO_CLASS},
+    [ATOM_WHITE_SPACE]                 = {"white-space", 11, KEYWORD_PROPERTY},
+    [ATOM_WIDOWS]                      = {"widows", 6, KEYWORD_PROPERTY},
+    [ATOM_WIDTH]                       = {"width", 5, KEYWORD_PROPERTY},
+    [ATOM_WILL_CHANGE]                 = {"will-change", 11, KEYWORD_PROPERTY},
+    [ATOM_WORD_BREAK]                  = {"word-break", 10, KEYWORD_PROPERTY},
+    [ATOM_WORD_SPACING]                = {"word-spacing", 12, KEYWORD_PROPERTY},
+    [ATOM_WORD_WRAP]                   = {"word-wrap", 9, KEYWORD_PROPERTY},
+    [ATOM_WRITING_MODE]                = {"writing-mode", 12, KEYWORD_PROPERTY},
+    [ATOM_X]                           = {"x", 1, KEYWORD_UNIT},
+    [ATOM_Z_INDEX]                     = {"z-index", 7, KEYWORD_PROPERTY},
+    [ATOM_ZOOM]                        = {"zoom", 4, KEYWORD_PROPERTY},
+};
+
+enum { KEYWORD_SLOT_BITS = 11, KEYWORD_BUCKETS = 512 };
+
+static const uint32_t keyword_displacements[KEYWORD_BUCKETS] = {
+    0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 1,
+    0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 1, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 1, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 1, 0, 0, 0,
+    1, 0, 0, 0, 1, 0, 0, 0,
+    1, 0, 0, 0, 0, 0, 1, 0,
+    0, 0, 0, 0, 0, 0, 1, 0,
+    1, 0, 2, 0, 0, 0, 0, 0,
+    1, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 1, 0, 0, 1, 0,
+    0, 0, 0, 0, 0, 0, 1, 0,
+    0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 1,
+    0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 1, 0, 0,
+    0, 0, 0, 0, 4, 0, 0, 1,
+    0, 0, 0, 0, 0, 0, 1, 0,
+    0, 0, 0, 0, 1, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 1, 0,
+    0, 0, 0, 1, 0, 0, 0, 0,
+    0, 1, 0, 0, 0, 3, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 2, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 1, 0, 0, 0, 0, 1,
+    0, 0, 0, 0, 1, 0, 0, 0,
+    0, 0, 0, 0, 0, 3, 1, 0,
+    0, 0, 0, 0, 0, 0, 0, 0,
+    1, 0, 0, 0, 2, 0, 0, 0,
+    0, 1, 0, 0, 0, 0, 0, 2,
+    0, 0, 0, 0, 0, 0, 1, 0,
+    1, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 1, 0, 0, 1, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 1, 0, 0, 0,
+    0, 0, 2, 0, 0, 0, 0, 0,
+    1, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 1, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0,
+    0, 1, 0, 0, 0, 0, 0, 0,
+    1, 0, 0, 0, 0, 0, 1, 0,
+    0, 0, 0, 0, 0, 1, 0, 0,
+    0, 0, 0, 2, 0, 1, 1, 0,
+    0, 0, 0, 0, 1, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 2,
+    0, 1, 0, 2, 0, 0, 0, 1,
+    1, 0, 1, 0, 0, 1, 0, 0,
+    0, 0, 2, 0, 0, 0, 0, 0,
+    0, 1, 0, 1, 0, 0, 0, 2,
+    0, 0, 1, 0, 1, 0, 0, 2,
+    0, 0, 0, 1, 0, 0, 0, 0,
+};
+
+static const unsigned short keyword_slots[1 << KEYWORD_SLOT_BITS] = {
+    [17] = ATOM_BORDER_IMAGE_WIDTH,
+    [21] = ATOM_BORDER_TOP_WIDTH,
+    [25] = ATOM_BORDER_LEFT,
+    [26] = ATOM_MM,
+    [31] = ATOM_FONT_FACE,
+    [34] = ATOM_BACKGROUND_POSITION,
+    [38] = ATOM_CONTAINER_TYPE,
+    [39] = ATOM_PADDING,
+    [45] = ATOM_CURRENTCOLOR,
+    [56] = ATOM_BORDER_END_START_RADIUS,
+    [60] = ATOM_MASK_SIZE,
+    [64] = ATOM_BACKGROUND_SIZE,
+    [72] = ATOM_CONTENT,
+    [74] = ATOM_BORDER_LEFT_COLOR,
+    [78] = ATOM_TEXT_DECORATION_STYLE,
+    [80] = ATOM_EMPTY_CELLS,
+    [84] = ATOM_STROKE_LINECAP,
+    [89] = ATOM_COLUMN_FILL,
+    [95] = ATOM_BLOCK_SIZE,
+    [98] = ATOM_OPACITY,
+    [103] = ATOM_TEXT_COMBINE_UPRIGHT,
+    [107] = ATOM_BORDER_INLINE_END_WIDTH,
+    [108] = ATOM_GRID_COLUMN_START,
+    [118] = ATOM_BORDER_TOP_STYLE,
+    [123] = ATOM_COLUMN_SPAN,
+    [125] = ATOM_BORDER_BLOCK_STYLE,
+    [126] = ATOM_BORDER_RIGHT,
+    [132] = ATOM_CONTAINER,
+    [135] = ATOM_BORDER_WIDTH,
+    [136] = ATOM_DPPX,
+    [137] = ATOM_EX,
+    [138] = ATOM_ATTR,
+    [148] = ATOM_SCROLL_PADDING,
+    [151] = ATOM_BORDER_IMAGE_SLICE,
+    [153] = ATOM_ROTATE,
+    [165] = ATOM_TEXT_EMPHASIS_POSITION,
+    [167] = ATOM_FIRST,
+    [172] = ATOM_MAX_BLOCK_SIZE,
+    [183] = ATOM_PLACE_CONTENT,
+    [184] = ATOM_PROPERTY,
+    [188] = ATOM_TRANSITION_DELAY,
+    [190] = ATOM_BORDER_TOP,
+    [192] = ATOM_HOST,
+    [194] = ATOM_BORDER_START_END_RADIUS,
+    [196] = ATOM_SCROLL_SNAP_TYPE,
+    [202] = ATOM_BACKGROUND_IMAGE,
+    [205] = ATOM_FONT_KERNING,
+    [206] = ATOM_PADDING_BLOCK,
+    [208] = ATOM_DEG,
+    [211] = ATOM_TOUCH_ACTION,
+    [214] = ATOM_VAR,
+    [217] = ATOM_TRANSITION_BEHAVIOR,
+    [219] = ATOM_OVERSCROLL_BEHAVIOR_Y,
+    [228] = ATOM_MARGIN_RIGHT,
+    [229] = ATOM_INSET_INLINE,
+    [235] = ATOM_GRID_COLUMN_END,
+    [236] = ATOM_LIST_STYLE,
+    [242] = ATOM_WEBKIT_LINE_CLAMP,
+    [252] = ATOM_DISPLAY,
+    [258] = ATOM_NTH_CHILD,
+    [262] = ATOM_MASK,
+    [263] = ATOM_HSL,
+    [265] = ATOM_IMAGE_RENDERING,
+    [267] = ATOM_BACKGROUND_ATTACHMENT,
+    [269] = ATOM_FLEX_WRAP,
+    [275] = ATOM_WHERE,
+    [278] = ATOM_WEBKIT_TEXT_STROKE,
+    [291] = ATOM_BORDER_BOTTOM_COLOR,
+    [293] = ATOM_GRID_AREA,
+    [294] = ATOM_FLEX_FLOW,
+    [302] = ATOM_GRID_COLUMN_GAP,
+    [303] = ATOM_VI,
+    [309] = ATOM_WEBKIT_TAP_HIGHLIGHT_COLOR,
+    [313] = ATOM_FONT_SIZE_ADJUST,
+    [317] = ATOM_FILL_OPACITY,
+    [319] = ATOM_RIGHT,
+    [324] = ATOM_SCROLL_PADDING_INLINE,
+    [325] = ATOM_TRANSITION,
+    [326] = ATOM_INLINE_SIZE,
+    [327] = ATOM_LAST_OF_TYPE,
+    [328] = ATOM_MIN_WIDTH,
+    [329] = ATOM_LAST_CHILD,
+    [330] = ATOM_BACKDROP_FILTER,
+    [338] = ATOM_BORDER_BLOCK_END_COLOR,
+    [341] = ATOM_KEYFRAMES,
+    [349] = ATOM_CQB,
+    [353] = ATOM_BORDER_INLINE_WIDTH,
+    [357] = ATOM_TARGET,
+    [366] = ATOM_BACKGROUND_POSITION_Y,
+    [369] = ATOM_SCROLL_MARGIN_BOTTOM,
+    [373] = ATOM_TEXT_TRANSFORM,
+    [380] = ATOM_FONT_WEIGHT,
+    [382] = ATOM_Q,
+    [383] = ATOM_OUTLINE_COLOR,
+    [386] = ATOM_WIDTH,
+    [389] = ATOM_COLOR_SCHEME,
+    [397] = ATOM_WEBKIT_BOX_ORIENT,
+    [399] = ATOM_INSET_BLOCK_END,
+    [403] = ATOM_STROKE_MITERLIMIT,
+    [404] = ATOM_BORDER_END_END_RADIUS,
+    [411] = ATOM_HAS,
+    [413] = ATOM_ANIMATION_DELAY,
+    [423] = ATOM_CALC,
+    [431] = ATOM_ONLY_CHILD,
+    [438] = ATOM_TAB_SIZE,
+    [445] = ATOM_ORDER,
+    [447] = ATOM_BORDER_INLINE,
+    [448] = ATOM_COLUMNS,
+    [452] = ATOM_BORDER_BLOCK_START,
+    [454] = ATOM_LINE_HEIGHT,
+    [455] = ATOM_MARGIN_BOTTOM,
+    [456] = ATOM_FLEX_GROW,
+    [460] = ATOM_TRANSFORM_STYLE,
+    [465] = ATOM_DROP_SHADOW,
+    [470] = ATOM_CHARSET,
+    [472] = ATOM_PC,
+    [483] = ATOM_BREAK_BEFORE,
+    [491] = ATOM_BORDER,
+    [498] = ATOM_EMPTY,
+    [501] = ATOM_ACCENT_COLOR,
+    [506] = ATOM_WORD_WRAP,
+    [509] = ATOM_CM,
+    [513] = ATOM_DIRECTION,
+    [517] = ATOM_CONIC_GRADIENT,
+    [523] = ATOM_RAD,
+    [527] = ATOM_ALIGN_ITEMS,
+    [532] = ATOM_GRID_TEMPLATE_AREAS,
+    [545] = ATOM_COLUMN_RULE,
+    [548] = ATOM_STROKE_DASHARRAY,
+    [552] = ATOM_NONE,
+    [558] = ATOM_POSITION,
+    [561] = ATOM_FLEX_BASIS,
+    [562] = ATOM_ORPHANS,
+    [563] = ATOM_OVERFLOW_Y,
+    [564] = ATOM_BORDER_BLOCK_START_WIDTH,
+    [565] = ATOM_WEBKIT_TEXT_STROKE_COLOR,
+    [566] = ATOM_STOP_OPACITY,
+    [568] = ATOM_GRAD,
+    [570] = ATOM_UNSET,
+    [571] = ATOM_GRID_AUTO_COLUMNS,
+    [573] = ATOM_CAP,
+    [578] = ATOM_UNICODE_RANGE,
+    [584] = ATOM_LINK,
+    [591] = ATOM_VMIN,
+    [592] = ATOM_MS_FLEX,
+    [599] = ATOM_PRINT_COLOR_ADJUST,
+    [604] = ATOM_FLOAT,
+    [606] = ATOM_GRID_AUTO_ROWS,
+    [612] = ATOM_TEXT_ORIENTATION,
+    [616] = ATOM_FONT_FEATURE_SETTINGS,
+    [618] = ATOM_MAX,
+    [619] = ATOM_CQW,
+    [627] = ATOM_COUNTER_SET,
+    [629] = ATOM_SHAPE_OUTSIDE,
+    [632] = ATOM_MARGIN_TOP,
+    [636] = ATOM_OUTLINE,
+    [639] = ATOM_COLOR,
+    [647] = ATOM_GRID_TEMPLATE,
+    [655] = ATOM_OBJECT_POSITION,
+    [657] = ATOM_SCROLL_MARGIN_INLINE,
+    [658] = ATOM_WRITING_MODE,
+    [665] = ATOM_FONT_SYNTHESIS,
+    [668] = ATOM_BORDER_INLINE_START_COLOR,
+    [672] = ATOM_ROW_GAP,
+    [673] = ATOM_WILL_CHANGE,
+    [681] = ATOM_INSET_INLINE_END,
+    [682] = ATOM_ENABLED,
+    [686] = ATOM_FLEX_SHRINK,
+    [704] = ATOM_JUSTIFY_CONTENT,
+    [705] = ATOM_DVW,
+    [706] = ATOM_TRANSFORM,
+    [708] = ATOM_BOX_SHADOW,
+    [711] = ATOM_FILL,
+    [712] = ATOM_OVERSCROLL_BEHAVIOR_X,
+    [713] = ATOM_PADDING_BOTTOM,
+    [715] = ATOM_CLAMP,
+    [721] = ATOM_PADDING_BLOCK_END,
+    [723] = ATOM_BACKGROUND_CLIP,
+    [724] = ATOM_SCROLL_SNAP_ALIGN,
+    [727] = ATOM_PADDING_INLINE_START,
+    [729] = ATOM_FLEX_DIRECTION,
+    [731] = ATOM_MARKER,
+    [735] = ATOM_STOP_COLOR,
+    [736] = ATOM_COUNTER,
+    [737] = ATOM_FONT_PALETTE_VALUES,
+    [738] = ATOM_ANIMATION_FILL_MODE,
+    [749] = ATOM_CLIP,
+    [759] = ATOM_IC,
+    [761] = ATOM_TEXT_ALIGN,
+    [773] = ATOM_FONT_VARIATION_SETTINGS,
+    [776] = ATOM_COLUMN_GAP,
+    [779] = ATOM_LIST_STYLE_POSITION,
+    [781] = ATOM_BORDER_BLOCK_END_WIDTH,
+    [783] = ATOM_APPEARANCE,
+    [787] = ATOM_TEXT_JUSTIFY,
+    [789] = ATOM_MARGIN_LEFT,
+    [794] = ATOM_MARGIN,
+    [799] = ATOM_SRC,
+    [803] = ATOM_COLUMN_COUNT,
+    [806] = ATOM_MARGIN_INLINE_START,
+    [819] = ATOM_POINTER_EVENTS,
+    [820] = ATOM_X,
+    [822] = ATOM_BORDER_INLINE_COLOR,
+    [824] = ATOM_PERSPECTIVE,
+    [827] = ATOM_BORDER_BLOCK_END,
+    [839] = ATOM_ANIMATION_COMPOSITION,
+    [850] = ATOM_BORDER_RIGHT_WIDTH,
+    [851] = ATOM_MASK_IMAGE,
+    [855] = ATOM_ANIMATION,
+    [856] = ATOM_GRID,
+    [859] = ATOM_BACKGROUND_POSITION_X,
+    [864] = ATOM_MS,
+    [866] = ATOM_RESIZE,
+    [867] = ATOM_WEBKIT_USER_SELECT,
+    [868] = ATOM_BOX_DECORATION_BREAK,
+    [870] = ATOM_HEIGHT,
+    [873] = ATOM_SVH,
+    [874] = ATOM_SUPPORTS,
+    [881] = ATOM_MASK_POSITION,
+    [884] = ATOM_NTH_LAST_CHILD,
+    [886] = ATOM_LIST_STYLE_TYPE,
+    [889] = ATOM_OUTLINE_WIDTH,
+    [890] = ATOM_MARGIN_BLOCK_START,
+    [892] = ATOM_ASPECT_RATIO,
+    [898] = ATOM_CQI,
+    [900] = ATOM_HZ,
+    [906] = ATOM_CARET_COLOR,
+    [909] = ATOM_DPI,
+    [910] = ATOM_BREAK_AFTER,
+    [912] = ATOM_FONT_STYLE,
+    [917] = ATOM_MARGIN_BLOCK_END,
+    [922] = ATOM_ROOT,
+    [923] = ATOM_FONT_STRETCH,
+    [925] = ATOM_LETTER_SPACING,
+    [927] = ATOM_CLIP_PATH,
+    [928] = ATOM_CH,
+    [929] = ATOM_BORDER_BLOCK_WIDTH,
+    [939] = ATOM_BOTTOM,
+    [945] = ATOM_ZOOM,
+    [946] = ATOM_INVALID,
+    [949] = ATOM_VISITED,
+    [951] = ATOM_BORDER_BOTTOM_WIDTH,
+    [954] = ATOM_OFFSET,
+    [961] = ATOM_CAPTION_SIDE,
+    [967] = ATOM_KHZ,
+    [969] = ATOM_ALIGN_SELF,
+    [971] = ATOM_BORDER_INLINE_STYLE,
+    [972] = ATOM_NTH_LAST_OF_TYPE,
+    [974] = ATOM_SCROLL_PADDING_RIGHT,
+    [985] = ATOM_EM,
+    [996] = ATOM_BORDER_INLINE_END,
+    [1011] = ATOM_TEXT_EMPHASIS_STYLE,
+    [1014] = ATOM_MARGIN_INLINE,
+    [1018] = ATOM_BORDER_BLOCK_END_STYLE,
+    [1020] = ATOM_VB,
+    [1029] = ATOM_PAGE,
+    [1039] = ATOM_SCROLL_MARGIN_BLOCK,
+    [1043] = ATOM_WEBKIT_FONT_SMOOTHING,
+    [1045] = ATOM_BACKGROUND_REPEAT,
+    [1047] = ATOM_FLEX,
+    [1049] = ATOM_INSET_BLOCK,
+    [1050] = ATOM_BREAK_INSIDE,
+    [1056] = ATOM_OVERFLOW_X,
+    [1057] = ATOM_IS,
+    [1060] = ATOM_FOCUS,
+    [1062] = ATOM_TEXT_SHADOW,
+    [1065] = ATOM_LH,
+    [1066] = ATOM_BORDER_BOTTOM_STYLE,
+    [1071] = ATOM_BORDER_RIGHT_STYLE,
+    [1073] = ATOM_TRANSFORM_ORIGIN,
+    [1080] = ATOM_FLOOD_OPACITY,
+    [1081] = ATOM_BORDER_RIGHT_COLOR,
+    [1091] = ATOM_FONT_VARIANT_EAST_ASIAN,
+    [1092] = ATOM_RGB,
+    [1096] = ATOM_TEXT_UNDERLINE_OFFSET,
+    [1100] = ATOM_BORDER_IMAGE_SOURCE,
+    [1101] = ATOM_HYPHENS,
+    [1104] = ATOM_VW,
+    [1110] = ATOM_SCROLL_BEHAVIOR,
+    [1116] = ATOM_STROKE_LINEJOIN,
+    [1117] = ATOM_ISOLATION,
+    [1121] = ATOM_CONTENT_VISIBILITY,
+    [1128] = ATOM_PADDING_BLOCK_START,
+    [1130] = ATOM_BORDER_COLLAPSE,
+    [1137] = ATOM_WORD_BREAK,
+    [1139] = ATOM_URL,
+    [1142] = ATOM_TRANSITION_PROPERTY,
+    [1147] = ATOM_PERSPECTIVE_ORIGIN,
+    [1149] = ATOM_WEBKIT_TEXT_FILL_COLOR,
+    [1152] = ATOM_GAP,
+    [1161] = ATOM_SCALE,
+    [1164] = ATOM_PADDING_INLINE_END,
+    [1166] = ATOM_ANIMATION_ITERATION_COUNT,
+    [1170] = ATOM_TRANSPARENT,
+    [1172] = ATOM_SHAPE_IMAGE_THRESHOLD,
+    [1173] = ATOM_BORDER_TOP_COLOR,
+    [1176] = ATOM_VISIBILITY,
+    [1179] = ATOM_FONT_FEATURE_VALUES,
+    [1181] = ATOM_BORDER_INLINE_START_STYLE,
+    [1187] = ATOM_NOT,
+    [1190] = ATOM_GRID_ROW_START,
+    [1192] = ATOM_NORMAL,
+    [1194] = ATOM_PADDING_LEFT,
+    [1195] = ATOM_WEBKIT_TEXT_STROKE_WIDTH,
+    [1205] = ATOM_ONLY_OF_TYPE,
+    [1217] = ATOM_SVW,
+    [1220] = ATOM_CONTAINER_NAME,
+    [1230] = ATOM_LEFT,
+    [1237] = ATOM_PAGE_BREAK_AFTER,
+    [1241] = ATOM_DEFAULT,
+    [1247] = ATOM_MAX_WIDTH,
+    [1250] = ATOM_SCOPE,
+    [1258] = ATOM_JUSTIFY_ITEMS,
+    [1259] = ATOM_FONT_OPTICAL_SIZING,
+    [1263] = ATOM_PT,
+    [1265] = ATOM_MEDIA,
+    [1267] = ATOM_OVERFLOW_WRAP,
+    [1272] = ATOM_WHITE_SPACE,
+    [1275] = ATOM_TEXT_DECORATION,
+    [1277] = ATOM_FONT_VARIANT_CAPS,
+    [1278] = ATOM_DOCUMENT,
+    [1282] = ATOM_INSET,
+    [1285] = ATOM_COUNTER_STYLE,
+    [1286] = ATOM_FILTER,
+    [1287] = ATOM_FLOOD_COLOR,
+    [1288] = ATOM_RLH,
+    [1289] = ATOM_FONT_VARIANT_LIGATURES,
+    [1291] = ATOM_REQUIRED,
+    [1293] = ATOM_TEXT_DECORATION_THICKNESS,
+    [1294] = ATOM_COLUMN_RULE_WIDTH,
+    [1297] = ATOM_STARTING_STYLE,
+    [1299] = ATOM_FR,
+    [1300] = ATOM_HSLA,
+    [1302] = ATOM_SCROLL_MARGIN_TOP,
+    [1307] = ATOM_STROKE_WIDTH,
+    [1312] = ATOM_LIGHTING_COLOR,
+    [1317] = ATOM_WEBKIT_FLEX,
+    [1322] = ATOM_Z_INDEX,
+    [1326] = ATOM_LINE_BREAK,
+    [1327] = ATOM_IN,
+    [1328] = ATOM_PLACE_SELF,
+    [1331] = ATOM_GRID_TEMPLATE_COLUMNS,
+    [1333] = ATOM_SCROLLBAR_WIDTH,
+    [1340] = ATOM_LAYER,
+    [1353] = ATOM_MARGIN_BLOCK,
+    [1359] = ATOM_SCROLL_SNAP_STOP,
+    [1360] = ATOM_ANIMATION_NAME,
+    [1361] = ATOM_REPEATING_LINEAR_GRADIENT,
+    [1363] = ATOM_FIRST_CHILD,
+    [1368] = ATOM_PLACE_ITEMS,
+    [1369] = ATOM_TEXT_INDENT,
+    [1371] = ATOM_BORDER_BLOCK,
+    [1372] = ATOM_MIN,
+    [1377] = ATOM_BORDER_SPACING,
+    [1381] = ATOM_BACKGROUND_COLOR,
+    [1383] = ATOM_FONT_VARIANT,
+    [1393] = ATOM_TRANSFORM_BOX,
+    [1394] = ATOM_OUTLINE_OFFSET,
+    [1400] = ATOM_GRID_AUTO_FLOW,
+    [1408] = ATOM_BORDER_TOP_RIGHT_RADIUS,
+    [1416] = ATOM_TEXT_UNDERLINE_POSITION,
+    [1417] = ATOM_TRANSITION_DURATION,
+    [1419] = ATOM_PADDING_RIGHT,
+    [1420] = ATOM_FOCUS_VISIBLE,
+    [1431] = ATOM_COLUMN_WIDTH,
+    [1434] = ATOM_BORDER_BLOCK_COLOR,
+    [1435] = ATOM_FONT_VARIANT_NUMERIC,
+    [1438] = ATOM_VMAX,
+    [1446] = ATOM_MAX_INLINE_SIZE,
+    [1455] = ATOM_WIDOWS,
+    [1467] = ATOM_BORDER_LEFT_STYLE,
+    [1468] = ATOM_FILL_RULE,
+    [1470] = ATOM_READ_WRITE,
+    [1476] = ATOM_NTH_OF_TYPE,
+    [1480] = ATOM_TEXT_WRAP,
+    [1482] = ATOM_CURSOR,
+    [1484] = ATOM_REVERT,
+    [1485] = ATOM_SCROLLBAR_COLOR,
+    [1488] = ATOM_MIN_HEIGHT,
+    [1493] = ATOM_PADDING_TOP,
+    [1494] = ATOM_LVW,
+    [1495] = ATOM_ALL,
+    [1496] = ATOM_DVH,
+    [1498] = ATOM_BORDER_RADIUS,
+    [1507] = ATOM_REPEATING_CONIC_GRADIENT,
+    [1513] = ATOM_OVERSCROLL_BEHAVIOR,
+    [1532] = ATOM_BORDER_BOTTOM_LEFT_RADIUS,
+    [1535] = ATOM_VIEWPORT,
+    [1537] = ATOM_TEXT_EMPHASIS_COLOR,
+    [1542] = ATOM_FONT_DISPLAY,
+    [1543] = ATOM_GRID_TEMPLATE_ROWS,
+    [1544] = ATOM_TEXT_ALIGN_LAST,
+    [1556] = ATOM_LIST_STYLE_IMAGE,
+    [1569] = ATOM_TRANSLATE,
+    [1572] = ATOM_BORDER_INLINE_START_WIDTH,
+    [1578] = ATOM_IN_RANGE,
+    [1585] = ATOM_REM,
+    [1591] = ATOM_MASK_REPEAT,
+    [1593] = ATOM_STROKE_DASHOFFSET,
+    [1596] = ATOM_BORDER_COLOR,
+    [1607] = ATOM_WEBKIT_APPEARANCE,
+    [1610] = ATOM_BORDER_INLINE_END_STYLE,
+    [1615] = ATOM_CHECKED,
+    [1620] = ATOM_TEXT_DECORATION_LINE,
+    [1623] = ATOM_COLUMN_RULE_COLOR,
+    [1625] = ATOM_CONTAIN,
+    [1626] = ATOM_UNICODE_BIDI,
+    [1630] = ATOM_RADIAL_GRADIENT,
+    [1631] = ATOM_INHERIT,
+    [1633] = ATOM_CQMAX,
+    [1635] = ATOM_INSET_BLOCK_START,
+    [1637] = ATOM_MIX_BLEND_MODE,
+    [1648] = ATOM_GRID_GAP,
+    [1649] = ATOM_LINEAR_GRADIENT,
+    [1654] = ATOM_GRID_ROW,
+    [1663] = ATOM_CLEAR,
+    [1664] = ATOM_TURN,
+    [1667] = ATOM_VALID,
+    [1670] = ATOM_OPTIONAL,
+    [1672] = ATOM_BORDER_STYLE,
+    [1680] = ATOM_ANIMATION_DIRECTION,
+    [1682] = ATOM_TRANSITION_TIMING_FUNCTION,
+    [1689] = ATOM_LIGHT_DARK,
+    [1693] = ATOM_TOP,
+    [1694] = ATOM_SCROLL_MARGIN_LEFT,
+    [1700] = ATOM_MAX_HEIGHT,
+    [1701] = ATOM_QUOTES,
+    [1702] = ATOM_SCROLL_PADDING_LEFT,
+    [1705] = ATOM_TEXT_SIZE_ADJUST,
+    [1709] = ATOM_BORDER_INLINE_START,
+    [1712] = ATOM_BORDER_INLINE_END_COLOR,
+    [1713] = ATOM_OVERFLOW,
+    [1714] = ATOM_ENV,
+    [1716] = ATOM_BORDER_START_START_RADIUS,
+    [1720] = ATOM_GRID_ROW_END,
+    [1726] = ATOM_ANIMATION_TIMING_FUNCTION,
+    [1733] = ATOM_HOVER,
+    [1736] = ATOM_SCROLL_PADDING_BLOCK,
+    [1739] = ATOM_BORDER_BLOCK_START_STYLE,
+    [1740] = ATOM_SCROLL_PADDING_TOP,
+    [1741] = ATOM_OUT_OF_RANGE,
+    [1742] = ATOM_S,
+    [1749] = ATOM_BORDER_BOTTOM_RIGHT_RADIUS,
+    [1750] = ATOM_ACTIVE,
+    [1754] = ATOM_CQMIN,
+    [1759] = ATOM_FULLSCREEN,
+    [1770] = ATOM_MIN_INLINE_SIZE,
+    [1771] = ATOM_DPCM,
+    [1773] = ATOM_REPEATING_RADIAL_GRADIENT,
+    [1779] = ATOM_COLUMN_RULE_STYLE,
+    [1782] = ATOM_BORDER_BOTTOM,
+    [1784] = ATOM_FONT_FAMILY,
+    [1789] = ATOM_DEFINED,
+    [1798] = ATOM_BORDER_IMAGE,
+    [1806] = ATOM_INDETERMINATE,
+    [1807] = ATOM_FIRST_OF_TYPE,
+    [1809] = ATOM_ANY_LINK,
+    [1815] = ATOM_PAGE_BREAK_INSIDE,
+    [1819] = ATOM_SPEAK,
+    [1829] = ATOM_COUNTER_INCREMENT,
+    [1831] = ATOM_ANIMATION_DURATION,
+    [1836] = ATOM_INITIAL,
+    [1837] = ATOM_PAGE_BREAK_BEFORE,
+    [1842] = ATOM_WORD_SPACING,
+    [1849] = ATOM_SHAPE_MARGIN,
+    [1854] = ATOM_PADDING_INLINE,
+    [1857] = ATOM_VH,
+    [1858] = ATOM_BOX_SIZING,
+    [1864] = ATOM_NAMESPACE,
+    [1865] = ATOM_BORDER_BLOCK_START_COLOR,
+    [1868] = ATOM_MARGIN_INLINE_END,
+    [1871] = ATOM_BACKGROUND_BLEND_MODE,
+    [1872] = ATOM_FOCUS_WITHIN,
+    [1874] = ATOM_COLOR_MIX,
+    [1877] = ATOM_PAINT_ORDER,
+    [1878] = ATOM_DISABLED,
+    [1879] = ATOM_GRID_ROW_GAP,
+    [1881] = ATOM_OUTLINE_STYLE,
+    [1882] = ATOM_BACKFACE_VISIBILITY,
+    [1884] = ATOM_AUTO,
+    [1887] = ATOM_ALIGN_CONTENT,
+    [1888] = ATOM_MIN_BLOCK_SIZE,
+    [1890] = ATOM_SCROLL_MARGIN_RIGHT,
+    [1892] = ATOM_GRID_COLUMN,
+    [1901] = ATOM_WEBKIT_OVERFLOW_SCROLLING,
+    [1905] = ATOM_TABLE_LAYOUT,
+    [1908] = ATOM_FONT_SIZE,
+    [1910] = ATOM_USER_SELECT,
+    [1911] = ATOM_RGBA,
+    [1917] = ATOM_READ_ONLY,
+    [1925] = ATOM_FONT,
+    [1932] = ATOM_VERTICAL_ALIGN,
+    [1933] = ATOM_TEXT_EMPHASIS,
+    [1934] = ATOM_BORDER_TOP_LEFT_RADIUS,
+    [1939] = ATOM_IMPORT,
+    [1950] = ATOM_TEXT_DECORATION_SKIP_INK,
+    [1953] = ATOM_OBJECT_FIT,
+    [1956] = ATOM_BORDER_LEFT_WIDTH,
+    [1957] = ATOM_STROKE_OPACITY,
+    [1963] = ATOM_TEXT_DECORATION_COLOR,
+    [1965] = ATOM_COUNTER_RESET,
+    [1969] = ATOM_CQH,
+    [1971] = ATOM_PX,
+    [1982] = ATOM_INSET_INLINE_START,
+    [1987] = ATOM_LVH,
+    [1989] = ATOM_ANIMATION_PLAY_STATE,
+    [1995] = ATOM_BORDER_IMAGE_REPEAT,
+    [2000] = ATOM_SCROLL_PADDING_BOTTOM,
+    [2002] = ATOM_BORDER_IMAGE_OUTSET,
+    [2004] = ATOM_JUSTIFY_SELF,
+    [2007] = ATOM_BACKGROUND,
+    [2012] = ATOM_OVERFLOW_ANCHOR,
+    [2013] = ATOM_TEXT_RENDERING,
+    [2018] = ATOM_SCROLLBAR_GUTTER,
+    [2026] = ATOM_LANG,
+    [2034] = ATOM_TEXT_OVERFLOW,
+    [2038] = ATOM_PLACEHOLDER_SHOWN,
+    [2041] = ATOM_STROKE,
+    [2043] = ATOM_BACKGROUND_ORIGIN,
+    [2045] = ATOM_WEBKIT_TEXT_SIZE_ADJUST,
+    [2047] = ATOM_SCROLL_MARGIN,
+};
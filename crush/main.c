@@ -1,19 +1,466 @@
+#define _POSIX_C_SOURCE 200809L
 #include "crush.h"
+#include <stdbool.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+static int usage(const char* name) {
+    fprintf(stderr, "usage: %s [--minify] [--preserve-comments] [-j threads] [file]\n", name);
+    fprintf(stderr, "       %s [--minify] [--preserve-comments] [-j jobs] [-r] -o outdir path...\n", name);
+    return EXIT_FAILURE;
+}
+
+// Batch mode
+
+// Each file given is written to the output directory under its own name, and
+// each file found below a directory given with -r under its path from there.
+// Files are parsed on a pool of workers. They are sorted largest first and
+// dealt out in turn, and a worker that runs out takes the smallest waiting
+// file of another, so one big file does not leave the rest of the pool idle.
+
+struct job {
+    char* input;
+    char* output;
+    off_t size;
+};
+
+struct worker {
+    pthread_t thread;
+    struct batch* batch;
+    pthread_mutex_t lock;
+    struct job** queue; // the owner takes from the front, others from the back
+    size_t front;
+    size_t back;
+    size_t failures;
+};
+
+struct batch {
+    const char* outdir;
+    mode_t mode; // for the files written, as open(..., 0666) would make them
+    bool minify;
+    bool comments;
+    struct job* jobs;
+    size_t count;
+    size_t capacity;
+    struct worker* workers;
+    size_t worker_count;
+};
+
+static char* join(const char* directory, const char* name) {
+    size_t a = strlen(directory), b = strlen(name);
+    char* result = malloc(a + b + 2);
+    if (!result) {
+        fprintf(stderr, "Error allocating memory");
+        exit(EXIT_FAILURE);
+    }
+    memcpy(result, directory, a);
+    result[a] = '/';
+    memcpy(result + a + 1, name, b + 1);
+    return result;
+}
+
+static void add_job(struct batch* b, const char* input, const char* relative, off_t size) {
+    if (b->count == b->capacity) {
+        b->capacity = b->capacity ? b->capacity * 2 : 64;
+        b->jobs = realloc(b->jobs, b->capacity * sizeof(struct job));
+        if (!b->jobs) {
+            fprintf(stderr, "Error allocating memory");
+            exit(EXIT_FAILURE);
+        }
+    }
+    struct job* job = &b->jobs[b->count++];
+    job->input = strdup(input);
+    job->output = join(b->outdir, relative);
+    job->size = size;
+}
+
+static bool is_stylesheet(const char* name) {
+    size_t length = strlen(name);
+    return length > 4 && strcmp(name + length - 4, ".css") == 0;
+}
+
+// Add the stylesheets below `directory`, `relative` being its path below the
+// directory that was given. Returns how many entries could not be read.
+static size_t add_directory(struct batch* b, const char* directory, const char* relative) {
+    DIR* dir = opendir(directory);
+    if (!dir) {
+        perror(directory);
+        return 1;
+    }
+
+    size_t failures = 0;
+    struct dirent* entry;
+    while ((entry = readdir(dir))) {
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) continue;
+
+        char* path = join(directory, entry->d_name);
+        char* name = relative ? join(relative, entry->d_name) : strdup(entry->d_name);
+        struct stat st;
+        if (stat(path, &st) != 0) {
+            perror(path);
+            failures++;
+        } else if (S_ISDIR(st.st_mode)) {
+            failures += add_directory(b, path, name);
+        } else if (S_ISREG(st.st_mode) && is_stylesheet(entry->d_name)) {
+            add_job(b, path, name, st.st_size);
+        }
+        free(name);
+        free(path);
+    }
+    closedir(dir);
+    return failures;
+}
+
+// Add a path from the command line. Returns how many paths could not be added.
+static size_t add_path(struct batch* b, const char* path, bool recursive) {
+    struct stat st;
+    if (stat(path, &st) != 0) {
+        perror(path);
+        return 1;
+    }
+    if (S_ISDIR(st.st_mode)) {
+        if (!recursive) {
+            fprintf(stderr, "%s: is a directory, use -r to minify the stylesheets in it\n", path);
+            return 1;
+        }
+        return add_directory(b, path, NULL);
+    }
+    if (!S_ISREG(st.st_mode)) {
+        fprintf(stderr, "%s: not a regular file\n", path);
+        return 1;
+    }
+    const char* name = strrchr(path, '/');
+    add_job(b, path, name ? name + 1 : path, st.st_size);
+    return 0;
+}
+
+// Create the directories `path` is in.
+static int make_parents(char* path) {
+    for (char* slash = strchr(path + 1, '/'); slash; slash = strchr(slash + 1, '/')) {
+        *slash = '\0';
+        int result = mkdir(path, 0777);
+        int error = errno;
+        *slash = '/';
+        if (result != 0 && error != EEXIST) {
+            errno = error;
+            return -1;
+        }
+    }
+    return 0;
+}
+
+// With files parsed side by side, an error has to say which one it is in.
+static void report_error(void* data, const char* reason, unsigned line, unsigned column) {
+    const struct job* job = data;
+    fprintf(stderr, "%s:%u:%u: Parse error: %s\n", job->input, line, column, reason);
+}
+
+// Minify one file into `*ss`, the stylesheet the worker last parsed into. The
+// result goes to a temporary file beside the output, renamed over it only once
+// it is all written, so a job that fails leaves what was there before. The
+// input is mapped rather than read, so writing over it in place would also
+// pull the stylesheet out from under the parse.
+static bool run_job(struct batch* b, struct job* job, struct stylesheet** ss) {
+    struct stat in, out;
+    if (stat(job->input, &in) != 0) {
+        perror(job->input);
+        return false;
+    }
+    if (stat(job->output, &out) == 0 && in.st_dev == out.st_dev && in.st_ino == out.st_ino) {
+        fprintf(stderr, "%s: is the same file as its output\n", job->input);
+        return false;
+    }
+
+    struct lexer* L = lexer_init_mmap(job->input);
+    if (!L) {
+        perror(job->input);
+        return false;
+    }
+    struct crush_context context = {b->comments, report_error, job};
+    lexer_set_context(L, &context);
+
+    if (make_parents(job->output) != 0) {
+        perror(job->output);
+        lexer_free(L);
+        return false;
+    }
+    size_t length = strlen(job->output);
+    char* temporary = malloc(length + sizeof(".XXXXXX"));
+    if (!temporary) {
+        fprintf(stderr, "Error allocating memory");
+        exit(EXIT_FAILURE);
+    }
+    memcpy(temporary, job->output, length);
+    memcpy(temporary + length, ".XXXXXX", sizeof(".XXXXXX"));
+    int fd = mkstemp(temporary);
+    if (fd < 0) {
+        perror(job->output);
+        free(temporary);
+        lexer_free(L);
+        return false;
+    }
+
+    *ss = parse_stylesheet_reusing(L, *ss);
+    struct output* file = output_fd(fd);
+    if (b->minify) {
+        stylesheet_optimize(*ss);
+        stylesheet_write_minified(*ss, file);
+    } else {
+        stylesheet_write(*ss, file);
+    }
+
+    bool ok = output_flush(file) == 0 && fchmod(fd, b->mode) == 0;
+    output_free(file);
+    ok = close(fd) == 0 && ok;
+    ok = ok && rename(temporary, job->output) == 0;
+    if (!ok) {
+        perror(job->output);
+        unlink(temporary);
+    }
+    free(temporary);
+    lexer_free(L);
+    return ok;
+}
+
+static struct job* take(struct worker* w) {
+    struct job* job = NULL;
+    pthread_mutex_lock(&w->lock);
+    if (w->front < w->back) {
+        job = w->queue[w->front++];
+    }
+    pthread_mutex_unlock(&w->lock);
+    return job;
+}
+
+static struct job* steal(struct worker* w) {
+    struct job* job = NULL;
+    pthread_mutex_lock(&w->lock);
+    if (w->front < w->back) {
+        job = w->queue[--w->back];
+    }
+    pthread_mutex_unlock(&w->lock);
+    return job;
+}
+
+static void* work(void* arg) {
+    struct worker* w = arg;
+    struct batch* b = w->batch;
+    struct stylesheet* ss = NULL;
+    size_t self = w - b->workers;
+
+    // No jobs are added once the workers start, so when every queue is
+    // empty the batch is done.
+    for (;;) {
+        struct job* job = take(w);
+        for (size_t i = 1; !job && i < b->worker_count; i++) {
+            job = steal(&b->workers[(self + i) % b->worker_count]);
+        }
+        if (!job) break;
+        if (!run_job(b, job, &ss)) {
+            w->failures++;
+        }
+    }
+
+    if (ss) {
+        stylesheet_free(ss);
+    }
+    return NULL;
+}
+
+static int by_output(const void* a, const void* b) {
+    return strcmp(((const struct job*)a)->output, ((const struct job*)b)->output);
+}
+
+// Files with the same name in different places would be written to one output
+// by workers racing each other. Returns how many outputs are claimed twice.
+static size_t shared_outputs(struct batch* b) {
+    size_t failures = 0;
+    qsort(b->jobs, b->count, sizeof(struct job), by_output);
+    for (size_t i = 1; i < b->count; i++) {
+        if (strcmp(b->jobs[i - 1].output, b->jobs[i].output) == 0) {
+            fprintf(stderr, "%s: would be written from both %s and %s\n", b->jobs[i].output,
+                    b->jobs[i - 1].input, b->jobs[i].input);
+            failures++;
+        }
+    }
+    return failures;
+}
+
+static int largest_first(const void* a, const void* b) {
+    off_t x = ((const struct job*)a)->size, y = ((const struct job*)b)->size;
+    return (x < y) - (x > y);
+}
+
+static size_t run_batch(struct batch* b, size_t worker_count) {
+    if (worker_count > b->count) worker_count = b->count;
+    if (worker_count == 0) return 0;
+    qsort(b->jobs, b->count, sizeof(struct job), largest_first);
+
+    b->worker_count = worker_count;
+    b->workers = calloc(worker_count, sizeof(struct worker));
+    if (!b->workers) {
+        fprintf(stderr, "Error allocating memory");
+        exit(EXIT_FAILURE);
+    }
+    for (size_t i = 0; i < worker_count; i++) {
+        struct worker* w = &b->workers[i];
+        w->batch = b;
+        pthread_mutex_init(&w->lock, NULL);
+        w->queue = malloc((b->count / worker_count + 1) * sizeof(struct job*));
+        if (!w->queue) {
+            fprintf(stderr, "Error allocating memory");
+            exit(EXIT_FAILURE);
+        }
+        for (size_t j = i; j < b->count; j += worker_count) {
+            w->queue[w->back++] = &b->jobs[j];
+        }
+    }
+
+    // The calling thread is the first worker.
+    size_t started = 1;
+    for (; started < worker_count; started++) {
+        int error = pthread_create(&b->workers[started].thread, NULL, work, &b->workers[started]);
+        if (error) {
+            // The rest of the jobs are stolen by the workers that did start.
+            fprintf(stderr, "Could not start a worker: %s\n", strerror(error));
+            break;
+        }
+    }
+    work(&b->workers[0]);
+
+    size_t failures = b->workers[0].failures;
+    for (size_t i = 1; i < started; i++) {
+        pthread_join(b->workers[i].thread, NULL);
+        failures += b->workers[i].failures;
+    }
+    for (size_t i = 0; i < worker_count; i++) {
+        pthread_mutex_destroy(&b->workers[i].lock);
+        free(b->workers[i].queue);
+    }
+    free(b->workers);
+    return failures;
+}
+
+static int batch_main(struct batch* b, const char** paths, size_t path_count,
+                      bool recursive, long worker_count) {
+    size_t failures = 0;
+    for (size_t i = 0; i < path_count; i++) {
+        failures += add_path(b, paths[i], recursive);
+    }
+
+    mode_t mask = umask(0);
+    umask(mask);
+    b->mode = 0666 & ~mask;
+
+    if (shared_outputs(b) != 0) {
+        // Nothing is written rather than leave it to chance which file wins.
+        failures++;
+    } else if (mkdir(b->outdir, 0777) != 0 && errno != EEXIST) {
+        perror(b->outdir);
+        failures++;
+    } else {
+        failures += run_batch(b, worker_count);
+    }
+
+    for (size_t i = 0; i < b->count; i++) {
+        free(b->jobs[i].input);
+        free(b->jobs[i].output);
+    }
+    free(b->jobs);
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
 
 int main(int argc, const char * argv[])
 {
-    FILE* input;
+    struct lexer* L;
+    bool minify = false;
+    bool comments = false;
+    bool recursive = false;
+    const char* outdir = NULL;
+    long jobs = 0;
+    const char** paths = calloc(argc, sizeof(const char*));
+    size_t path_count = 0;
 
-    if (argc < 2) {
-        input = stdin;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--minify") == 0) {
+            minify = true;
+        } else if (strcmp(argv[i], "--preserve-comments") == 0) {
+            comments = true;
+        } else if (strcmp(argv[i], "-r") == 0) {
+            recursive = true;
+        } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            outdir = argv[++i];
+        } else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+            char* end;
+            jobs = strtol(argv[++i], &end, 10);
+            if (*end != '\0' || jobs < 1) {
+                return usage(argv[0]);
+            }
+        } else if (argv[i][0] == '-' && argv[i][1] != '\0') {
+            return usage(argv[0]);
+        } else {
+            paths[path_count++] = argv[i];
+        }
+    }
+
+    if (outdir) {
+        if (path_count == 0) {
+            return usage(argv[0]);
+        }
+        if (jobs == 0) {
+            jobs = sysconf(_SC_NPROCESSORS_ONLN);
+            if (jobs < 1) jobs = 1;
+        }
+        struct batch b = {outdir, 0, minify, comments, NULL, 0, 0, NULL, 0};
+        int status = batch_main(&b, paths, path_count, recursive, jobs);
+        free(paths);
+        return status;
+    }
+
+    if (recursive || path_count > 1) {
+        return usage(argv[0]);
+    }
+    const char* path = path_count ? paths[0] : NULL;
+    free(paths);
+
+    if (!path) {
+        L = lexer_init(stdin);
     } else {
-        input = fopen(argv[1], "r");
+        L = lexer_init_mmap(path);
     }
 
-    struct lexer* L = lexer_init(input);
-    struct stylesheet* ss = parse_stylesheet(L);
-    stylesheet_print(ss, stdout);
+    if (!L) {
+        perror(path ? path : "stdin");
+        return EXIT_FAILURE;
+    }
 
-    return 0;
-}
\ No newline at end of file
+    if (comments) {
+        lexer_preserve_comments(L);
+    }
+
+    struct stylesheet* ss = jobs ? parse_stylesheet_parallel(L, jobs) : parse_stylesheet(L);
+    struct output* out = output_fd(STDOUT_FILENO);
+    if (minify) {
+        stylesheet_optimize(ss);
+        stylesheet_write_minified(ss, out);
+    } else {
+        stylesheet_write(ss, out);
+    }
+
+    int status = output_flush(out) == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    if (status != EXIT_SUCCESS) {
+        perror("stdout");
+    }
+
+    output_free(out);
+    stylesheet_free(ss);
+    lexer_free(L);
+    return status;
+}
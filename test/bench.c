@@ -0,0 +1,224 @@
+#define _POSIX_C_SOURCE 200809L
+#include "crush.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// A stylesheet of `count` copies of `item`, optionally wrapped as
+// prefix ... suffix.
+static char* repeat(const char* prefix, const char* item, const char* suffix,
+                    size_t count, size_t* size) {
+    size_t prefix_length = strlen(prefix);
+    size_t item_length = strlen(item);
+    size_t suffix_length = strlen(suffix);
+
+    *size = prefix_length + count * item_length + suffix_length;
+    char* data = malloc(*size);
+    char* out = data;
+
+    memcpy(out, prefix, prefix_length);
+    out += prefix_length;
+    for (size_t i = 0; i < count; i++) {
+        memcpy(out, item, item_length);
+        out += item_length;
+    }
+    memcpy(out, suffix, suffix_length);
+    return data;
+}
+
+static void time_parse(const char* label, const char* prefix, const char* item,
+                       const char* suffix, size_t count) {
+    size_t size;
+    char* data = repeat(prefix, item, suffix, count, &size);
+
+    struct lexer* lexer = lexer_init_memory(data, size);
+    double start = now();
+    struct stylesheet* ss = parse_stylesheet(lexer);
+    double elapsed = now() - start;
+
+    struct crush_stats stats;
+    stylesheet_stats(ss, &stats);
+
+    printf("%-12s %8zu items %9.2f ms %8.1f ns/item %8zu mallocs %8.1f allocations/KB\n",
+           label, count, elapsed * 1e3, elapsed * 1e9 / count, stats.mallocs,
+           stats.allocations * 1024.0 / size);
+
+    stylesheet_free(ss);
+    lexer_free(lexer);
+    free(data);
+}
+
+// Per-item cost should stay flat as the input grows.
+static void scaling(void) {
+    for (size_t count = 1000; count <= 1000000; count *= 10) {
+        time_parse("rules", "", ".icon{background-position:-16px 0}\n", "", count);
+    }
+    for (size_t count = 1000; count <= 1000000; count *= 10) {
+        time_parse("declarations", "a{", "margin:0 auto;", "}", count);
+    }
+    for (size_t count = 1000; count <= 1000000; count *= 10) {
+        time_parse("arguments", "a{b:f(", "1,", ")}", count);
+    }
+}
+
+// The whole of a file, or null if it cannot be read.
+static char* slurp(const char* path, size_t* size) {
+    FILE* file = fopen(path, "rb");
+    if (!file) return NULL;
+    fseek(file, 0, SEEK_END);
+    *size = ftell(file);
+    rewind(file);
+    char* data = malloc(*size + 1);
+    if (fread(data, 1, *size, file) != *size) {
+        free(data);
+        data = NULL;
+    }
+    fclose(file);
+    return data;
+}
+
+// Tokenizer throughput over `sheet` repeated to a few megabytes, once for
+// each set of run scanners.
+static void tokenize(const char* label, const char* sheet) {
+    size_t size;
+    char* data = repeat("", sheet, "", (8 << 20) / strlen(sheet) + 1, &size);
+
+    const char* scanners[] = {"scalar", "sse2", "avx2"};
+    for (size_t i = 0; i < sizeof(scanners) / sizeof(*scanners); i++) {
+        setenv("CRUSH_SCAN", scanners[i], 1);
+        struct lexer* lexer = lexer_init_memory(data, size);
+        size_t tokens = 0;
+        double start = now();
+        for (;;) {
+            struct token* token = lexer_next(lexer);
+            enum token_type type = token_type(token);
+            token_free(token);
+            tokens++;
+            if (type == TOKEN_EOF) break;
+        }
+        double elapsed = now() - start;
+        lexer_free(lexer);
+
+        printf("%-12s %-6s %6.1f MB %9.2f ms %8.1f MB/s %8.1f ns/token\n",
+               label, scanners[i], size / 1e6, elapsed * 1e3, size / 1e6 / elapsed, elapsed * 1e9 / tokens);
+    }
+    unsetenv("CRUSH_SCAN");
+    free(data);
+}
+
+// Parsing straight from the lexer against tokenizing to a tape first and
+// parsing the tape.
+static void tape(const char* label, const char* sheet) {
+    size_t size;
+    char* data = repeat("", sheet, "", (8 << 20) / strlen(sheet) + 1, &size);
+
+    struct lexer* lexer = lexer_init_memory(data, size);
+    double start = now();
+    struct stylesheet* ss = parse_stylesheet(lexer);
+    double parse = now() - start;
+    stylesheet_free(ss);
+    lexer_free(lexer);
+
+    lexer = lexer_init_memory(data, size);
+    start = now();
+    struct token_tape* tape = lexer_tokenize_all(lexer);
+    double tokenize = now() - start;
+    ss = parse_token_tape(tape);
+    double total = now() - start;
+    size_t tokens = tape->count;
+    stylesheet_free(ss);
+    token_tape_free(tape);
+    lexer_free(lexer);
+
+    printf("%-12s %8zu tokens %9.2f ms lexer %9.2f ms tape (%.2f ms tokenizing)\n",
+           label, tokens, parse * 1e3, total * 1e3, tokenize * 1e3);
+    free(data);
+}
+
+// Passes over a parsed stylesheet: the optimizer and the minified printer.
+static void walk(const char* label, const char* sheet) {
+    size_t size;
+    char* data = repeat("", sheet, "", (8 << 20) / strlen(sheet) + 1, &size);
+
+    struct lexer* lexer = lexer_init_memory(data, size);
+    struct stylesheet* ss = parse_stylesheet(lexer);
+    struct output* out = output_memory();
+
+    double start = now();
+    stylesheet_optimize(ss);
+    double optimize = now() - start;
+    start = now();
+    stylesheet_write_minified(ss, out);
+    double write = now() - start;
+
+    printf("%-12s %6.1f MB %9.2f ms optimize %9.2f ms write\n",
+           label, size / 1e6, optimize * 1e3, write * 1e3);
+
+    output_free(out);
+    stylesheet_free(ss);
+    lexer_free(lexer);
+    free(data);
+}
+
+// One large input parsed in pieces on more and more threads, against
+// parse_stylesheet on the same input.
+static void threads(const char* label, const char* sheet) {
+    size_t size;
+    char* data = repeat("", sheet, "", (32 << 20) / strlen(sheet) + 1, &size);
+
+    struct lexer* lexer = lexer_init_memory(data, size);
+    double start = now();
+    struct stylesheet* ss = parse_stylesheet(lexer);
+    double sequential = now() - start;
+    stylesheet_free(ss);
+    lexer_free(lexer);
+    printf("%-12s %6.1f MB %9.2f ms in one go\n", label, size / 1e6, sequential * 1e3);
+
+    for (unsigned count = 1; count <= 8; count *= 2) {
+        lexer = lexer_init_memory(data, size);
+        start = now();
+        ss = parse_stylesheet_parallel(lexer, count);
+        double elapsed = now() - start;
+        stylesheet_free(ss);
+        lexer_free(lexer);
+        printf("%-12s %6u threads %9.2f ms %6.2fx\n", label, count, elapsed * 1e3, sequential / elapsed);
+    }
+    free(data);
+}
+
+int main(int argc, const char * argv[])
+{
+    (void)argc;
+    (void)argv;
+    scaling();
+
+    size_t size;
+    char* sheet = slurp("test/default.css", &size);
+    if (sheet) {
+        sheet[size] = '\0';
+        tokenize("default.css", sheet);
+        tape("default.css", sheet);
+        walk("default.css", sheet);
+        threads("default.css", sheet);
+        free(sheet);
+    }
+
+    // Long names, strings and indentation, where the run scanners matter most.
+    tokenize("long runs",
+             ".navigation-menu__item--highlighted-with-a-long-modifier-name {\n"
+             "                content: \"a fairly long string of generated content text\";\n"
+             "                font-family: \"Helvetica Neue Condensed Bold Oblique\";\n"
+             "}\n");
+
+    // Numbers, which the tokenizer no longer converts up front.
+    tokenize("numbers",
+             "a{margin:0.5em 1.25em -3px 100%;transform:matrix(1.0,0.0,0.0,1.0,12.5,-7.25)}\n");
+    return 0;
+}
@@ -0,0 +1,69 @@
+#!/bin/sh
+# Tests of the command line, run as: test/cli.sh path/to/crush
+crush=$(cd "$(dirname "$1")" && pwd)/$(basename "$1")
+passes=0
+fails=0
+
+dir=$(mktemp -d)
+trap 'rm -rf "$dir"' EXIT
+cd "$dir" || exit 1
+
+fail() {
+    echo "$*"
+    fails=$((fails + 1))
+}
+
+pass() {
+    passes=$((passes + 1))
+}
+
+# expect_file path contents
+expect_file() {
+    if [ "$(cat "$1" 2>/dev/null)" = "$2" ]; then
+        pass
+    else
+        fail "Expected $1 to hold \"$2\" but it held \"$(cat "$1" 2>/dev/null)\""
+    fi
+}
+
+# expect_status status command...
+expect_status() {
+    expected=$1
+    shift
+    "$@" >/dev/null 2>&1
+    status=$?
+    if [ "$status" -eq "$expected" ]; then
+        pass
+    else
+        fail "Expected \"$*\" to exit with $expected but it exited with $status"
+    fi
+}
+
+mkdir d
+printf 'a { color : red }\n' > d/x.css
+
+# A batch writes each file under its name in the output directory.
+expect_status 0 "$crush" --minify -o out d/x.css
+expect_file out/x.css 'a{color:red}'
+
+# Writing a file over itself would lose it, so the job fails and the file is
+# left as it was.
+expect_status 1 "$crush" --minify -o d d/x.css
+expect_file d/x.css 'a { color : red }'
+
+# Two inputs with one name would be written to one output, so nothing is.
+mkdir e
+printf 'b { color : blue }\n' > e/x.css
+expect_status 1 "$crush" --minify -o shared d/x.css e/x.css
+expect_status 1 test -e shared/x.css
+
+# Only regular files are read in a batch.
+expect_status 1 "$crush" --minify -o dev /dev/null
+expect_status 1 test -e dev/null
+
+# A pipe is read rather than mapped.
+printf 'a { color : red }\n' | "$crush" --minify /dev/stdin > piped.css
+expect_file piped.css 'a{color:red}'
+
+echo "cli passed: $passes failed: $fails"
+[ "$fails" -eq 0 ]
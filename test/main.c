@@ -1,9 +1,14 @@
+#define _POSIX_C_SOURCE 200809L
 #include "crush.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdarg.h>
+#include <ctype.h>
+#include <stdbool.h>
 #include <math.h>
+#include <unistd.h>
+#include <pthread.h>
 
 static int passes = 0;
 static int fails   = 0;
@@ -82,10 +87,7 @@ int test_number(const char* repr, double value) {
     return test_number_to(repr, value, 0.0000001);
 }
 
-int test(const char* data, const int* tokens) {
-
-    FILE* file = file_with_contents(data);
-    struct lexer* lexer = lexer_init(file);
+static int test_lexer(struct lexer* lexer, const char* data, const int* tokens) {
     for (;;) {
         struct token* token = lexer_next(lexer);
         int found = token_type(token);
@@ -99,7 +101,6 @@ int test(const char* data, const int* tokens) {
         tokens++;
         token_free(token);
     }
-    fclose(file);
 
     if (*tokens != TOKEN_EOF) {
         fail("Error token none at the end of the input %s\n", token_name(*tokens));
@@ -111,6 +112,22 @@ int test(const char* data, const int* tokens) {
     return 1;
 }
 
+int test(const char* data, const int* tokens) {
+    FILE* file = file_with_contents(data);
+    struct lexer* lexer = lexer_init(file);
+    int result = test_lexer(lexer, data, tokens);
+    lexer_free(lexer);
+    fclose(file);
+    return result;
+}
+
+int test_memory(const char* data, size_t size, const int* tokens) {
+    struct lexer* lexer = lexer_init_memory(data, size);
+    int result = test_lexer(lexer, data, tokens);
+    lexer_free(lexer);
+    return result;
+}
+
 void numbers() {
     test_number("123E+10", 123E+10);
     test_number("1.0", 1.0);
@@ -118,14 +135,141 @@ void numbers() {
     test_number("-8", -8);
     test_number("+8", +8);
     test_number("8e1", 8E1);
+
+    // Converted to the nearest double, however many digits there are.
+    test_number_to("0.1", 0.1, 0);
+    test_number_to("1e23", 1e23, 0);
+    test_number_to("9007199254740993", 9007199254740993.0, 0);
+    test_number_to("3.14159265358979323846264338327950288419716939937510",
+                   3.14159265358979323846264338327950288419716939937510, 0);
+    test_number_to("1.00000000000000011102230246251565404236316680908203125",
+                   1.00000000000000011102230246251565404236316680908203125, 0);
+    test_number_to("1.00000000000000011102230246251565404236316680908203126",
+                   1.00000000000000011102230246251565404236316680908203126, 0);
+    test_number_to("2.2250738585072011e-308", 2.2250738585072011e-308, 0);
+    test_number_to("4.9e-324", 4.9e-324, 0);
+    test_number_to("0.0000000000000000000000000000001234567890123456789012e+31",
+                   1.234567890123456789012, 0);
+    test_number_to("1e400", INFINITY, 0);
+}
+
+// The atoms of the non-whitespace tokens in data.
+static size_t test_atoms(const char* data, int* atoms, size_t max) {
+    struct lexer* lexer = lexer_init_memory(data, strlen(data));
+    size_t count = 0;
+    for (;;) {
+        struct token* token = lexer_next(lexer);
+        enum token_type type = token_type(token);
+        if (type != TOKEN_WHITESPACE && type != TOKEN_EOF && count < max) {
+            atoms[count++] = token_atom(token);
+        }
+        token_free(token);
+        if (type == TOKEN_EOF) break;
+    }
+    lexer_free(lexer);
+    return count;
+}
+
+void atoms() {
+    // Names are the same atom whatever their case or escapes, and whatever
+    // kind of token they name.
+    const char* data = "margin Margin m\\41 rgin margin( @margin 0margin foo FOO px 1PX #margin 'px'";
+    int atoms[16];
+    size_t count = test_atoms(data, atoms, 16);
+
+    if (count != 12) {
+        fail("Expected 12 tokens in \"%s\" but got %zu\n", data, count);
+    } else if (atoms[0] == 0 || atoms[1] != atoms[0] || atoms[2] != atoms[0] ||
+               atoms[3] != atoms[0] || atoms[4] != atoms[0] || atoms[5] != atoms[0]) {
+        fail("Expected each margin in \"%s\" to have one atom\n", data);
+    } else if (atoms[6] == 0 || atoms[7] != atoms[6] || atoms[6] == atoms[0]) {
+        fail("Expected foo and FOO to share an atom of their own\n");
+    } else if (atoms[8] == 0 || atoms[9] != atoms[8] || atoms[8] == atoms[6]) {
+        fail("Expected the px ident and unit to share an atom\n");
+    } else if (atoms[10] != 0 || atoms[11] != 0) {
+        fail("Expected hashes and strings to have no atom\n");
+    } else {
+        passes++;
+    }
+
+    // Enough names to grow the table, each still found again.
+    char* names = malloc(5000 * 8);
+    char* out = names;
+    for (int i = 0; i < 2500; i++) out += sprintf(out, "n%d ", i);
+    for (int i = 0; i < 2500; i++) out += sprintf(out, "N%d ", i);
+    int* many = malloc(5000 * sizeof(int));
+    count = test_atoms(names, many, 5000);
+    size_t mismatched = 0;
+    for (int i = 0; i < 2500; i++) {
+        mismatched += many[i] != many[2500 + i] || (i > 0 && many[i] == many[i - 1]);
+    }
+    if (count != 5000 || mismatched) {
+        fail("Expected 2500 distinct atoms, each twice, but %zu were not\n", mismatched);
+    } else {
+        passes++;
+    }
+    free(many);
+    free(names);
+}
+
+static int compare_names(const void* a, const void* b) {
+    return strcmp(*(char* const*)a, *(char* const*)b);
+}
+
+// Keywords are the first atoms, in the order of their sorted names. Each one
+// listed must be found, in any case, and nothing else may be.
+void keywords() {
+    FILE* file = fopen("tools/keywords.txt", "r");
+    if (!file) {
+        fail("Could not open tools/keywords.txt\n");
+        return;
+    }
+
+    char* names[1024];
+    size_t count = 0;
+    char line[256];
+    while (fgets(line, sizeof(line), file) && count < 1024) {
+        char name[256];
+        if (line[0] == '#' || line[0] == '[' || sscanf(line, "%255s", name) != 1) continue;
+        names[count++] = strdup(name);
+    }
+    fclose(file);
+
+    qsort(names, count, sizeof(names[0]), compare_names);
+    size_t unique = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (unique == 0 || strcmp(names[unique - 1], names[i]) != 0) {
+            names[unique++] = names[i];
+        } else {
+            free(names[i]);
+        }
+    }
+
+    size_t wrong = 0;
+    for (size_t i = 0; i < unique; i++) {
+        char upper[256];
+        for (size_t j = 0; j <= strlen(names[i]); j++) upper[j] = toupper(names[i][j]);
+
+        char data[1024];
+        snprintf(data, sizeof(data), "%s %s %sx", names[i], upper, names[i]);
+        int atoms[3];
+        if (test_atoms(data, atoms, 3) != 3 || atoms[0] != (int)i + 1 || atoms[1] != atoms[0]) {
+            if (wrong++ < 5) fail("Expected keyword %s to be atom %zu\n", names[i], i + 1);
+        } else if (atoms[2] <= (int)unique) {
+            if (wrong++ < 5) fail("Expected %sx not to be a keyword\n", names[i]);
+        }
+        free(names[i]);
+    }
+    if (wrong == 0) passes++;
 }
 
 void tokens() {
 
-    int aa[] = {TOKEN_IDENT, TOKEN_EOF};
+    int aa[] = {TOKEN_IDENT, TOKEN_DELIM, TOKEN_IDENT, TOKEN_EOF};
     test("div.head", aa);
 
-    int ab[] = {TOKEN_IDENT, TOKEN_IDENT, TOKEN_LEFT_CURLY, TOKEN_RIGHT_CURLY, TOKEN_EOF};
+    int ab[] = {TOKEN_IDENT, TOKEN_DELIM, TOKEN_IDENT, TOKEN_WHITESPACE, TOKEN_IDENT,
+        TOKEN_WHITESPACE, TOKEN_LEFT_CURLY, TOKEN_WHITESPACE, TOKEN_RIGHT_CURLY, TOKEN_EOF};
     test("div.head table { }", ab);
 
     int a[] = {TOKEN_IDENT, TOKEN_WHITESPACE, TOKEN_LEFT_CURLY, TOKEN_WHITESPACE, TOKEN_RIGHT_CURLY, TOKEN_EOF};
@@ -179,6 +323,12 @@ void tokens() {
     int q[] = { TOKEN_IDENT, TOKEN_WHITESPACE, TOKEN_IDENT, TOKEN_WHITESPACE, TOKEN_IDENT, TOKEN_WHITESPACE, TOKEN_IDENT, TOKEN_EOF };
     test("abc\n\rabc\nabc\rabc", q);
 
+    int qa[] = { TOKEN_IDENT, TOKEN_WHITESPACE, TOKEN_IDENT, TOKEN_EOF };
+    test("abc\fabc", qa);
+
+    int qb[] = { TOKEN_NUMBER, TOKEN_DELIM, TOKEN_WHITESPACE, TOKEN_CDC, TOKEN_NUMBER, TOKEN_EOF };
+    test("1.\r\n-->-.5", qb);
+
     int r[] = {TOKEN_DASH_MATCH, TOKEN_DASH_MATCH, TOKEN_COLUMN, TOKEN_DELIM, TOKEN_EOF};
     test("|=|=|||", r);
 
@@ -205,10 +355,764 @@ void tokens() {
     int y[] = {TOKEN_IDENT, TOKEN_COLON, TOKEN_WHITESPACE, TOKEN_STRING, TOKEN_EOF };
     test("content: \"\\2193\"", y);
 
-    int z[] = {TOKEN_CDO, TOKEN_CDC, TOKEN_CDO, TOKEN_CDC, TOKEN_EOF};
+    int z[] = {TOKEN_CDO, TOKEN_WHITESPACE, TOKEN_CDC, TOKEN_WHITESPACE,
+               TOKEN_CDO, TOKEN_WHITESPACE, TOKEN_CDC, TOKEN_EOF};
     test("<!-- --> <!-- -->", z);
 
+    int za[] = {TOKEN_CDO, TOKEN_IDENT, TOKEN_WHITESPACE, TOKEN_CDC, TOKEN_IDENT, TOKEN_EOF};
+    test("<!--a -->b", za);
+
+    int zb[] = {TOKEN_IDENT, TOKEN_COLON, TOKEN_DIMENSION, TOKEN_EOF};
+    test("--x:0px", zb);
+
+
+}
+
+static int test_write(const char* data, const char* expected, bool minify, bool optimize,
+                      bool comments) {
+    struct lexer* lexer = lexer_init_memory(data, strlen(data));
+    if (comments) {
+        lexer_preserve_comments(lexer);
+    }
+    struct stylesheet* ss = parse_stylesheet(lexer);
+    if (optimize) {
+        stylesheet_optimize(ss);
+    }
+
+    struct output* out = output_memory();
+    if (minify) {
+        stylesheet_write_minified(ss, out);
+    } else {
+        stylesheet_write(ss, out);
+    }
+
+    size_t size;
+    const char* actual = output_data(out, &size);
+    int result = EXIT_SUCCESS;
+
+    if (size != strlen(expected) || memcmp(actual, expected, size) != 0) {
+        result = fail("Printing \"%s\" expected \"%s\" but got \"%.*s\"\n", data, expected, (int)size, actual);
+    } else {
+        passes++;
+    }
+
+    output_free(out);
+    stylesheet_free(ss);
+    lexer_free(lexer);
+    return result;
+}
+
+static int test_minify_stylesheet(struct stylesheet* ss, const char* expected, size_t size) {
+    struct output* out = output_memory();
+    stylesheet_write_minified(ss, out);
+    size_t actual_size;
+    const char* actual = output_data(out, &actual_size);
+    int result = EXIT_SUCCESS;
+
+    if (actual_size != size || memcmp(actual, expected, size) != 0) {
+        result = fail("Expected \"%.*s\" but got \"%.*s\"\n", (int)size, expected, (int)actual_size, actual);
+    } else {
+        passes++;
+    }
+    output_free(out);
+    return result;
+}
+
+int test_print(const char* data, const char* expected) {
+    return test_write(data, expected, false, false, false);
+}
+
+int test_minify(const char* data, const char* expected) {
+    return test_write(data, expected, true, false, false);
+}
+
+int test_optimize(const char* data, const char* expected) {
+    return test_write(data, expected, true, true, false);
+}
+
+int test_comments(const char* data, const char* expected) {
+    return test_write(data, expected, true, false, true);
+}
+
+// The types of the non-whitespace tokens in data.
+static size_t test_types(const char* data, int* types, size_t max) {
+    struct lexer* lexer = lexer_init_memory(data, strlen(data));
+    size_t count = 0;
+    for (;;) {
+        struct token* token = lexer_next(lexer);
+        enum token_type type = token_type(token);
+        if (type != TOKEN_WHITESPACE && type != TOKEN_EOF && count < max) {
+            types[count++] = type;
+        }
+        token_free(token);
+        if (type == TOKEN_EOF) break;
+    }
+    lexer_free(lexer);
+    return count;
+}
+
+// Minified output reads back as the tokens it was written from.
+int test_round_trip(const char* data, const char* expected) {
+    if (test_minify(data, expected) != EXIT_SUCCESS) return EXIT_FAILURE;
+
+    int before[64], after[64];
+    size_t count = test_types(data, before, 64);
+    if (test_types(expected, after, 64) != count || memcmp(before, after, count * sizeof(int)) != 0) {
+        return fail("Minified \"%s\" reads back as other tokens\n", data);
+    }
+    passes++;
+    return EXIT_SUCCESS;
+}
+
+void memory() {
+    int a[] = {TOKEN_IDENT, TOKEN_COLON, TOKEN_WHITESPACE, TOKEN_IDENT, TOKEN_EOF};
+    test_memory("color: orange", 13, a);
+
+    // The size bounds the input, not a terminator.
+    int b[] = {TOKEN_IDENT, TOKEN_COLON, TOKEN_EOF};
+    test_memory("color: orange", 6, b);
+
+    int c[] = {TOKEN_IDENT, TOKEN_WHITESPACE, TOKEN_IDENT, TOKEN_WHITESPACE, TOKEN_IDENT, TOKEN_EOF};
+    test_memory("abc\r\nabc\rabc", 13, c);
+
+    int d[] = {TOKEN_EOF};
+    test_memory("", 0, d);
+
+    // A pipe has no size to map, so it is read instead.
+    const char* data = "color: orange";
+    int fds[2];
+    if (pipe(fds) != 0 || write(fds[1], data, strlen(data)) != (ssize_t)strlen(data)) {
+        fail("Could not write to a pipe\n");
+        return;
+    }
+    close(fds[1]);
+    char path[32];
+    snprintf(path, sizeof(path), "/dev/fd/%d", fds[0]);
+    struct lexer* lexer = lexer_init_mmap(path);
+    if (!lexer) {
+        fail("Could not open %s\n", path);
+    } else {
+        test_lexer(lexer, data, a);
+        lexer_free(lexer);
+    }
+    close(fds[0]);
+}
+
+void utf8() {
+    int a[] = {TOKEN_IDENT, TOKEN_WHITESPACE, TOKEN_IDENT, TOKEN_EOF};
+    test("\xC3\xBC" "ber a\xE2\x86\x92" "b", a);
+
+    // A stray continuation byte decodes as U+FFFD, which is a name character.
+    int b[] = {TOKEN_IDENT, TOKEN_EOF};
+    test("a\x80" "b", b);
+
+    int c[] = {TOKEN_IDENT, TOKEN_COLON, TOKEN_IDENT, TOKEN_EOF};
+    test("b:\\e9", c);
+
+    test_print("a{content:\"\\2193 x\"}", "a {content : \"\xE2\x86\x93" "x\" }\n\n");
+    test_print("\xC3\xBC" "ber{b:\\e9}", "\xC3\xBC" "ber {b : \xC3\xA9 }\n\n");
+}
+
+// Long runs of name, string and whitespace characters are scanned in bulk,
+// with vector scanners where the CPU has them. Every scanner must agree,
+// including where a run ends on an escape, a non-ASCII character or a CR.
+void runs() {
+    const char* scanners[] = {"scalar", "sse2", "avx2"};
+    for (size_t i = 0; i < sizeof(scanners) / sizeof(*scanners); i++) {
+        setenv("CRUSH_SCAN", scanners[i], 1);
+        test_minify(".abcdefghijklmnopqrstuvwxyz-_0123456\\31 789ABCDEFGHIJ_klmnopqrst\xC3\xA9vw{}",
+                    ".abcdefghijklmnopqrstuvwxyz-_01234561789ABCDEFGHIJ_klmnopqrst\xC3\xA9vw{}");
+        test_minify("a{content:\"abcdefghijklmnopqrstuvwxyz0123456'789\\\"\xC3\xA9"
+                    "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789\"}",
+                    "a{content:\"abcdefghijklmnopqrstuvwxyz0123456'789\\\"\xC3\xA9"
+                    "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789\"}");
+        test_minify("a{b:x                          \r\n                                    y}",
+                    "a{b:x y}");
+
+        int a[] = {TOKEN_IDENT, TOKEN_WHITESPACE, TOKEN_BAD_STRING, TOKEN_WHITESPACE, TOKEN_IDENT, TOKEN_EOF};
+        test("abcdefghijklmnopqrstuvwxyz0123456789 \"abcdefghijklmnopqrstuvwxyz0123456789\r\n"
+             "\f\t                                  abcdefghijklmnopqrstuvwxyz0123456789", a);
+    }
+    unsetenv("CRUSH_SCAN");
+}
+
+void comments() {
+    int a[] = {TOKEN_IDENT, TOKEN_WHITESPACE, TOKEN_WHITESPACE, TOKEN_IDENT, TOKEN_EOF};
+    test("a /* x */ /**/b/*/ */", a);
+
+    int b[] = {TOKEN_IDENT, TOKEN_EOF};
+    test("a/* never closed *", b);
+
+    // A long comment, with line breaks of every kind, is skipped in one go.
+    size_t size = 64 * 1024;
+    char* data = malloc(size + 1);
+    memcpy(data, "a/*", 3);
+    for (size_t i = 3; i < size - 3; i++) {
+        data[i] = "* /\r\n\f!x"[i % 9];
+    }
+    memcpy(data + size - 3, "*/b", 3);
+    data[size] = '\0';
+    int c[] = {TOKEN_IDENT, TOKEN_IDENT, TOKEN_EOF};
+    test_memory(data, size, c);
+    free(data);
+
+    // Only /*! comments are kept, and only when asked for.
+    test_minify("/*! license */ a { b : c /*! here */ ; /* gone */ }", "a{b:c}");
+    test_comments("/*! license */ a { b : c /*! here */ ; /* gone */ }",
+                  "/*! license */a{b:c /*! here */}");
+    test_comments("a{}\n/*! one *//*! two */\n", "a{}/*! one *//*! two */");
+    test_comments("a{} /*! open", "a{}/*! open*/");
+}
+
+// `prefix`, then `count` copies of `item`, then `suffix`.
+static char* repeated(const char* prefix, const char* item, size_t count, const char* suffix) {
+    size_t prefix_length = strlen(prefix), item_length = strlen(item);
+    char* data = malloc(prefix_length + count * item_length + strlen(suffix) + 1);
+    char* out = data + prefix_length;
+    memcpy(data, prefix, prefix_length);
+    for (size_t i = 0; i < count; i++, out += item_length) {
+        memcpy(out, item, item_length);
+    }
+    strcpy(out, suffix);
+    return data;
+}
+
+// Multi-megabyte strings and at-keywords, broken up by escapes so that
+// their loops go round a million times. Consuming them must neither recurse
+// per character nor take more than linear time.
+void stress() {
+    size_t count = 1 << 20;
+
+    char* data = repeated("a{content:\"", "abcdefg\\41 ", count, "\"}");
+    char* expected = repeated("a{content:\"", "abcdefgA", count, "\"}");
+    test_minify(data, expected);
+    free(data);
+    free(expected);
+
+    data = repeated("a{content:'", "abcdefgh", count, "'}");
+    expected = repeated("a{content:\"", "abcdefgh", count, "\"}");
+    test_minify(data, expected);
+    free(data);
+    free(expected);
+
+    data = repeated("@", "abcdefg\\41 ", count, ";");
+    expected = repeated("@", "abcdefgA", count, ";");
+    test_minify(data, expected);
+    free(data);
+    free(expected);
+
+    data = repeated("a{}", "/**/", count, "b{}");
+    test_minify(data, "a{}b{}");
+    free(data);
+}
+
+// Many threads minifying at once through one context must each get what a
+// single thread does, and every parse error must reach the context's sink.
+enum { THREADED_INPUTS = 4, THREADED_THREADS = 8, THREADED_ROUNDS = 100 };
+
+struct threaded {
+    const struct crush_context* context;
+    const char* inputs[THREADED_INPUTS];
+    const char* expected[THREADED_INPUTS];
+    size_t sizes[THREADED_INPUTS];
+    int failures;
+};
+
+struct error_count {
+    pthread_mutex_t lock;
+    size_t count;
+};
+
+static void count_error(void* data, const char* reason, unsigned line, unsigned column) {
+    (void)reason;
+    (void)line;
+    (void)column;
+    struct error_count* errors = data;
+    pthread_mutex_lock(&errors->lock);
+    errors->count++;
+    pthread_mutex_unlock(&errors->lock);
+}
+
+static void* minify_rounds(void* arg) {
+    struct threaded* t = arg;
+    for (int round = 0; round < THREADED_ROUNDS; round++) {
+        for (int i = 0; i < THREADED_INPUTS; i++) {
+            struct output* out = output_memory();
+            crush_minify(t->context, t->inputs[i], strlen(t->inputs[i]), out);
+            size_t size;
+            const char* actual = output_data(out, &size);
+            if (size != t->sizes[i] || memcmp(actual, t->expected[i], size) != 0) {
+                t->failures++;
+            }
+            output_free(out);
+        }
+    }
+    return NULL;
+}
+
+void threaded() {
+    struct error_count errors = {PTHREAD_MUTEX_INITIALIZER, 0};
+    struct crush_context context;
+    crush_context_init(&context);
+    context.preserve_comments = true;
+    context.error = count_error;
+    context.error_data = &errors;
+
+    char* big = repeated("", "a{color:#ff0000;margin:0px 1.50em} ", 200, "");
+    struct threaded shared = {&context, {
+        "/*! keep */ a { color: rgb(255, 255, 255); } /* drop */ b { x: \\41 }",
+        "@media screen { a { background: url( x.png ) #aabbcc } }",
+        "a { content: 'x' } b",
+        big,
+    }, {NULL}, {0}, 0};
+
+    struct output* outputs[THREADED_INPUTS];
+    for (int i = 0; i < THREADED_INPUTS; i++) {
+        outputs[i] = output_memory();
+        crush_minify(&context, shared.inputs[i], strlen(shared.inputs[i]), outputs[i]);
+        shared.expected[i] = output_data(outputs[i], &shared.sizes[i]);
+    }
+    size_t errors_alone = errors.count;
+    errors.count = 0;
+
+    struct threaded threads[THREADED_THREADS];
+    pthread_t ids[THREADED_THREADS];
+    for (int i = 0; i < THREADED_THREADS; i++) {
+        threads[i] = shared;
+        pthread_create(&ids[i], NULL, minify_rounds, &threads[i]);
+    }
+    int failures = 0;
+    for (int i = 0; i < THREADED_THREADS; i++) {
+        pthread_join(ids[i], NULL);
+        failures += threads[i].failures;
+    }
+
+    size_t expected_errors = errors_alone * THREADED_THREADS * THREADED_ROUNDS;
+    if (errors_alone == 0) {
+        fail("Expected a parse error from the unfinished rule\n");
+    } else if (failures) {
+        fail("Expected every thread's output to match, but %d did not\n", failures);
+    } else if (errors.count != expected_errors) {
+        fail("Expected %zu parse errors but got %zu\n", expected_errors, errors.count);
+    } else {
+        passes++;
+    }
+
+    for (int i = 0; i < THREADED_INPUTS; i++) {
+        output_free(outputs[i]);
+    }
+    free(big);
+}
+
+struct error_log {
+    size_t count;
+    unsigned line;
+    unsigned column;
+};
+
+static void log_error(void* data, const char* reason, unsigned line, unsigned column) {
+    (void)reason;
+    struct error_log* log = data;
+    log->count++;
+    log->line = line;
+    log->column = column;
+}
+
+// Minify `data` after parsing it on `threads` threads, or in one go if 0.
+static struct output* minify_parsed(const char* data, unsigned threads, struct error_log* log) {
+    struct crush_context context;
+    crush_context_init(&context);
+    context.error = log_error;
+    context.error_data = log;
+
+    struct lexer* lexer = lexer_init_memory(data, strlen(data));
+    lexer_set_context(lexer, &context);
+    struct stylesheet* ss = threads ? parse_stylesheet_parallel(lexer, threads) : parse_stylesheet(lexer);
+    struct output* out = output_memory();
+    stylesheet_optimize(ss);
+    stylesheet_write_minified(ss, out);
+    stylesheet_free(ss);
+    lexer_free(lexer);
+    return out;
+}
+
+// Parsing in pieces must give exactly what parsing in one go does, errors
+// included.
+static int test_parallel(const char* data, unsigned threads) {
+    struct error_log expected_errors = {0, 0, 0}, actual_errors = {0, 0, 0};
+    struct output* expected_out = minify_parsed(data, 0, &expected_errors);
+    struct output* actual_out = minify_parsed(data, threads, &actual_errors);
+    size_t expected_size, actual_size;
+    const char* expected = output_data(expected_out, &expected_size);
+    const char* actual = output_data(actual_out, &actual_size);
+
+    int result = EXIT_SUCCESS;
+    if (actual_size != expected_size || memcmp(actual, expected, expected_size) != 0) {
+        result = fail("Expected the same %zu bytes as parsing in one go but got %zu\n",
+                      expected_size, actual_size);
+    } else if (actual_errors.count != expected_errors.count ||
+               actual_errors.line != expected_errors.line ||
+               actual_errors.column != expected_errors.column) {
+        result = fail("Expected %zu errors, the last at %u:%u, but got %zu at %u:%u\n",
+                      expected_errors.count, expected_errors.line, expected_errors.column,
+                      actual_errors.count, actual_errors.line, actual_errors.column);
+    } else {
+        passes++;
+    }
+    output_free(expected_out);
+    output_free(actual_out);
+    return result;
+}
+
+// The atoms of `data`'s names after parsing it on `threads` threads, or in one
+// go if 0.
+static int* parsed_atoms(const char* data, unsigned threads, size_t* count) {
+    struct lexer* lexer = lexer_init_memory(data, strlen(data));
+    struct stylesheet* ss = threads ? parse_stylesheet_parallel(lexer, threads) : parse_stylesheet(lexer);
+    *count = stylesheet_atoms(ss, NULL, 0);
+    int* atoms = malloc(*count * sizeof(int) + 1);
+    stylesheet_atoms(ss, atoms, *count);
+    stylesheet_free(ss);
+    lexer_free(lexer);
+    return atoms;
+}
+
+// Names keep the atoms parsing in one go gives them, whichever piece they
+// were in.
+static int test_parallel_atoms(const char* data, unsigned threads) {
+    size_t expected_count, actual_count;
+    int* expected = parsed_atoms(data, 0, &expected_count);
+    int* actual = parsed_atoms(data, threads, &actual_count);
+
+    int result = EXIT_SUCCESS;
+    if (actual_count != expected_count) {
+        result = fail("Expected %zu atoms but got %zu\n", expected_count, actual_count);
+    } else if (memcmp(actual, expected, expected_count * sizeof(int)) != 0) {
+        size_t i = 0;
+        while (actual[i] == expected[i]) i++;
+        result = fail("Expected atom %d for name %zu but got %d\n", expected[i], i, actual[i]);
+    } else {
+        passes++;
+    }
+    free(expected);
+    free(actual);
+    return result;
+}
+
+void parallel() {
+    size_t count = 20000;
+    char* data = repeated("", "a{color:#ff0000} b{content:'}'} @media x{c{d:url(e{f)}} /* } */\n",
+                          count, "");
+    test_parallel(data, 2);
+    test_parallel(data, 4);
+    test_parallel(data, 8);
+    free(data);
+
+    // Ends inside a rule's prelude, so the last piece reports an error.
+    data = repeated("", "a{b:rgb(0,0,0)}\r\n", count * 4, "c d");
+    test_parallel(data, 4);
+    free(data);
+
+    // A url whose name is escaped looks like a block to the search for cuts,
+    // and the quote in it like a string, so most cuts found land after the
+    // `)}`, inside the prelude of a rule. Parsing the pieces has to notice.
+    data = repeated("", "a{b:c}\nx{y:u\\72l(a'b) 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9}\n)}\nz{}\n",
+                    count + 7, "");
+    test_parallel(data, 8);
+    free(data);
+
+    // The first piece meets names the others do not, so the others number
+    // theirs differently until they are joined.
+    data = repeated("first{second:third}\n", "a{foo:bar-baz}\n", count * 4, "");
+    test_parallel_atoms(data, 4);
+    free(data);
+}
+
+static int test_tape_write(const char* data) {
+    struct lexer* lexer = lexer_init_memory(data, strlen(data));
+    struct stylesheet* ss = parse_stylesheet(lexer);
+    struct output* out = output_memory();
+    stylesheet_write_minified(ss, out);
+    size_t size;
+    const char* expected = output_data(out, &size);
+
+    struct lexer* tape_lexer = lexer_init_memory(data, strlen(data));
+    struct token_tape* tape = lexer_tokenize_all(tape_lexer);
+    struct stylesheet* tape_ss = parse_token_tape(tape);
+    token_tape_free(tape);
+    int result = test_minify_stylesheet(tape_ss, expected, size);
+
+    stylesheet_free(tape_ss);
+    lexer_free(tape_lexer);
+    output_free(out);
+    stylesheet_free(ss);
+    lexer_free(lexer);
+    return result;
+}
+
+// Parse `data`, which should end inside a rule's prelude, and check where the
+// error written to stderr says it is.
+static int test_error_position(const char* data, int line, int column) {
+    printf("ERROR POSITION: %d:%d\n", line, column);
+    FILE* errors = tmpfile();
+    fflush(stderr);
+    int saved = dup(fileno(stderr));
+    dup2(fileno(errors), fileno(stderr));
+
+    struct lexer* lexer = lexer_init_memory(data, strlen(data));
+    stylesheet_free(parse_stylesheet(lexer));
+    lexer_free(lexer);
+
+    fflush(stderr);
+    dup2(saved, fileno(stderr));
+    close(saved);
+    rewind(errors);
+    char message[256] = "";
+    if (!fgets(message, sizeof(message), errors)) {
+        message[0] = '\0';
+    }
+    fclose(errors);
+
+    int actual_line = 0, actual_column = 0;
+    const char* at = strstr(message, "line:");
+    if (!at || sscanf(at, "line:%d column: %d", &actual_line, &actual_column) != 2) {
+        return fail("No error position in '%s'\n", message);
+    }
+    if (actual_line != line || actual_column != column) {
+        return fail("Error at %d:%d, expected %d:%d\n", actual_line, actual_column, line, column);
+    }
+    passes++;
+    return EXIT_SUCCESS;
+}
+
+void errors() {
+    test_error_position("a", 1, 2);
+    test_error_position("a{}\n\n  b", 3, 4);
+    test_error_position("a{}\r\n\r\n  b", 3, 4);
+    test_error_position("a{}\r\r  b", 3, 4);
+    test_error_position("a{}\f\n b", 3, 3);
+    test_error_position("a{}\n\xC3\xA9 \xE2\x82\xAC b", 2, 6);
+    test_error_position("a{\n}/* x\n y */ b", 3, 8);
+}
+
+void tape() {
+    const char* data = "a /**/{ b:-1.5e1px \\31 x; c: #f\\0 } @x 'y' U+1-2 ~";
+    struct lexer* lexer = lexer_init_memory(data, strlen(data));
+    struct token_tape* tape = lexer_tokenize_all(lexer);
+
+    const unsigned char types[] = {
+        TOKEN_IDENT, TOKEN_WHITESPACE, TOKEN_LEFT_CURLY, TOKEN_WHITESPACE, TOKEN_IDENT,
+        TOKEN_COLON, TOKEN_DIMENSION, TOKEN_WHITESPACE, TOKEN_IDENT, TOKEN_SEMICOLON,
+        TOKEN_WHITESPACE, TOKEN_IDENT, TOKEN_COLON, TOKEN_WHITESPACE, TOKEN_HASH,
+        TOKEN_RIGHT_CURLY, TOKEN_WHITESPACE, TOKEN_AT_KEYWORD,
+        TOKEN_WHITESPACE, TOKEN_STRING, TOKEN_WHITESPACE, TOKEN_UNICODE_RANGE,
+        TOKEN_WHITESPACE, TOKEN_DELIM, TOKEN_EOF
+    };
+    size_t size;
+    const char* text;
+
+    if (tape->count != sizeof(types) || memcmp(tape->types, types, sizeof(types)) != 0) {
+        fail("Tape of \"%s\" has the wrong tokens\n", data);
+    } else if (tape->offsets[2] != 6 || tape->lengths[2] != 1 ||
+               tape->offsets[6] != 10 || tape->lengths[6] != 8 ||
+               tape->offsets[24] != strlen(data) || tape->lengths[24] != 0) {
+        fail("Tape of \"%s\" has the wrong spans\n", data);
+    } else if (token_tape_number(tape, 6) != -15 ||
+               (text = token_tape_unit(tape, 6, &size), size != 2 || memcmp(text, "px", 2) != 0) ||
+               (text = token_tape_text(tape, 8, &size), size != 2 || memcmp(text, "1x", 2) != 0) ||
+               (text = token_tape_text(tape, 14, &size), size != 4 || memcmp(text, "f\xEF\xBF\xBD", 4) != 0) ||
+               (text = token_tape_text(tape, 19, &size), size != 1 || text[0] != 'y') ||
+               token_tape_range_low(tape, 21) != 1 || token_tape_range_high(tape, 21) != 2 ||
+               token_tape_delim(tape, 23) != '~') {
+        fail("Tape of \"%s\" has the wrong values\n", data);
+    } else {
+        passes++;
+    }
+
+    token_tape_free(tape);
+    lexer_free(lexer);
+
+    // Parsing a tape gives the same stylesheet as parsing from the lexer.
+    test_tape_write("a{color:rgb(255,0,0);margin:0px}b{}");
+    test_tape_write("@media (min-width:10px){.\\31 x,#a\\:b>c{content:'\\'';u:url( a )}}");
+    test_tape_write("a{b:c");
+
+    // The lexer folds whitespace into the token after it while parsing; the
+    // tape keeps it as tokens.
+    test_tape_write("  <!-- a  /* x */ b , c>d  ~ e[ f = g ]{ h : i ( j , k ) ; ;}  -->\n");
+    test_tape_write("@media  screen /**/and (x : 1px){ a :hover/**/b { c : d } }\t@x y ;e f{}");
+}
+
+void minify() {
+    test_minify("a  >  b , c { color : red ; ; }", "a>b,c{color:red}");
+    test_minify("a b{x: 1px solid  red !important;}", "a b{x:1px solid red!important}");
+    test_minify("a :hover, a:focus {}", "a :hover,a:focus{}");
+    test_minify("@media all { div :first-child { color: red } @page :left { b : c } }",
+                "@media all{div :first-child{color:red}@page:left{b:c}}");
+    test_minify("a [href ^= 'x' ] {}", "a [href^=\"x\"]{}");
+    test_minify("@media screen and (max-width : 100px) { a { b : c } }",
+                "@media screen and (max-width:100px){a{b:c}}");
+    test_minify("@charset \"utf-8\" ; a{}", "@charset \"utf-8\";a{}");
+
+    // Tokens that would run together keep one space.
+    test_minify("a{margin:1px -2px; b: x -y; c: 1 - 2; d: calc(1px + 2px) }",
+                "a{margin:1px -2px;b:x -y;c:1 - 2;d:calc(1px + 2px)}");
+    test_minify("a{b: 50 % }", "a{b:50 %}");
+    test_round_trip("u + a { color: red }", "u + a{color:red}");
+    test_round_trip("a[b/ *=c]{} d{e:f / *g}", "a[b/ *=c]{}d{e:f / *g}");
+    test_round_trip("a{b:U + ? u + 1 u+ c u + \\66  u+x}", "a{b:U + ? u + 1 u + c u + f u + x}");
+
+    // Escapes are written back where the text needs them.
+    test_minify(".\\31 a{}", ".\\31 a{}");
+    test_round_trip("#\\31 23 { color: red } #-\\32 x, #123 {}", "#\\31 23{color:red}#-\\32x,#123{}");
+    test_minify("a{content:'it\\'s'}", "a{content:\"it's\"}");
+    test_minify("a{content:\"\\\"'\"}", "a{content:\"\\\"'\"}");
+    test_minify("a{b:url( x.png ); c:url(a\\ b)}", "a{b:url(x.png);c:url(\"a b\")}");
+
+    // A bad string is written open, with the quote it does not hold.
+    test_round_trip("a { content: 'ab\"c\n; d: 'e' }", "a{content:'ab\"c\n;d:\"e\"}");
+    test_round_trip("a { b: \"x\\\"\\7f \n}", "a{b:'x\"\\7f \n}");
+}
+
+void numeric() {
+    test_minify("a{b:0.50px +1 1.0e3 1.0 007 -0.0 100.0 0.0001 1e-7 1.5e300 10.0% 0.0%}",
+                "a{b:.5px 1 1e3 1.0 7 -.0 1e2 1e-4 1e-7 15e299 10% 0%}");
+
+    // Integers keep every digit, even those a double would lose.
+    test_minify("a{z-index:12345678901234567890}", "a{z-index:12345678901234567890}");
+    test_minify("a{b:0.30000000000000000000000000001 -1234567890.12345678901234567890}",
+                "a{b:.3 -1234567890.1234567}");
+
+    // Only a zero length in a declaration value loses its unit.
+    test_minify("a{margin:0px 0.0em;flex:1 1 0px;--x:0px;width:calc(0px + 1px);transition:0s}",
+                "a{margin:0 0;flex:1 1 0px;--x:0px;width:calc(0px + 1px);transition:0s}");
+    test_minify("@media all{a:hover{margin:0px}b:x 0px{}}", "@media all{a:hover{margin:0}b:x 0px{}}");
+
+    // A unit that reads as an exponent stays escaped.
+    test_minify("a{b:1\\65 3;c:1\\65 m}", "a{b:1\\65 3;c:1em}");
+}
+
+void colors() {
+    test_optimize("a{color:#FFFFFF;background:#ff0000 url(x.png);c:#ff000033;d:#123456}",
+                  "a{color:#fff;background:red url(x.png);c:#f003;d:#123456}");
+    test_optimize("a{b:rgb(255, 255, 255);c:rgba(255,0,0,.2);d:rgb(0 0 255 / 1);e:hsl(0 100% 50%)}",
+                  "a{b:#fff;c:#f003;d:#00f;e:red}");
+
+    // Names are only colors in color properties, and hex cannot hold
+    // every color exactly.
+    test_optimize("a{font-family:black;border:1px solid white;color:fuchsia;color:navy}",
+                  "a{font-family:black;border:1px solid #fff;color:#f0f;color:navy}");
+    test_optimize("a{g:rgba(255,0,0,.5);e:hsl(120,100%,25%);c:rgb(100%,0,0)}",
+                  "a{g:rgba(255,0,0,.5);e:hsl(120,100%,25%);c:rgb(100%,0,0)}");
+
+    // Selectors, custom properties and unknown functions keep their text.
+    test_optimize("#ffffff{--x:#ffffff;filter:x.gradient(c=#ffffff);b:linear-gradient(white,#000080)}",
+                  "#ffffff{--x:#ffffff;filter:x.gradient(c=#ffffff);b:linear-gradient(#fff,navy)}");
+    test_optimize("@media print{a{color:#000000}}", "@media print{a{color:#000}}");
+
+    // A {} block in a custom property's value is part of the value.
+    test_optimize("a{--x:{color:#ffffff;margin:0px;;};b:{color:#ffffff}}",
+                  "a{--x:{color:#ffffff;margin:0px;;};b:{color:#fff}}");
+    test_minify("@media all{--x:{a :b};c :d{}}", "@media all{--x:{a:b};c :d{}}");
+
+    // A var() fallback has names as colors only where its property does.
+    test_optimize("a{grid-area:var(--x, white);font-family:var(--f, Black);color:var(--c, white)}",
+                  "a{grid-area:var(--x,white);font-family:var(--f,Black);color:var(--c,#fff)}");
+    test_optimize("a{background:color-mix(in srgb,white,var(--c,white))}",
+                  "a{background:color-mix(in srgb,#fff,var(--c,#fff))}");
+    test_optimize("@media all{a:hover{color:blue}#aabbcc{color:red}a:hover #aabbcc{}}",
+                  "@media all{a:hover{color:#00f}#aabbcc{color:red}a:hover #aabbcc{}}");
+}
+
+void output() {
+    // Larger than the output buffer, so it has to be written in pieces.
+    size_t size = 200 * 1024;
+    char* data = malloc(size);
+    for (size_t i = 0; i < size; i++) {
+        data[i] = 'a' + i % 26;
+    }
+
+    FILE* file = tmpfile();
+    struct output* out = output_fd(fileno(file));
+    for (size_t i = 0; i < size; i += 1000) {
+        output_write(out, data + i, size - i < 1000 ? size - i : 1000);
+    }
+    output_free(out);
+
+    rewind(file);
+    char* back = malloc(size + 1);
+    size_t read = fread(back, 1, size + 1, file);
+    fclose(file);
+
+    if (read != size || memcmp(back, data, size) != 0) {
+        fail("Expected %zu bytes written through a descriptor but read %zu\n", size, read);
+    } else {
+        passes++;
+    }
+
+    free(back);
+    free(data);
+}
+
+void arena() {
+    const char* rule = "a { color: red; }\n";
+    size_t count = 1000;
+    size_t length = strlen(rule);
+    char* data = malloc(count * length);
+    for (size_t i = 0; i < count; i++) {
+        memcpy(data + i * length, rule, length);
+    }
+
+    struct lexer* lexer = lexer_init_memory(data, count * length);
+    struct stylesheet* ss = parse_stylesheet(lexer);
+    struct crush_stats stats;
+    stylesheet_stats(ss, &stats);
+
+    // Three tokens, and the rule and its five component values.
+    if (stats.allocations < count * 9) {
+        fail("Expected at least %zu allocations but got %zu\n", count * 9, stats.allocations);
+    } else if (stats.mallocs * 100 > stats.allocations) {
+        fail("Expected under one malloc per 100 allocations but got %zu for %zu\n", stats.mallocs, stats.allocations);
+    } else {
+        passes++;
+    }
+
+    stylesheet_free(ss);
+    lexer_free(lexer);
+    free(data);
+
+    // Punctuation and whitespace tokens are shared, not allocated, so each
+    // semicolon costs only its place in the block.
+    data = repeated("a{", " ;", count, " }");
+    lexer = lexer_init_memory(data, strlen(data));
+    ss = parse_stylesheet(lexer);
+    stylesheet_stats(ss, &stats);
+
+    if (stats.allocations > count + 10) {
+        fail("Expected about %zu arena allocations but got %zu\n", count, stats.allocations);
+    } else {
+        passes++;
+    }
+
+    // A stylesheet parsed into again keeps its memory, so a small one needs
+    // no more mallocs.
+    const char* small = "b { color: #ff0000; margin: 0px }";
+    struct lexer* reuse_lexer = lexer_init_memory(small, strlen(small));
+    ss = parse_stylesheet_reusing(reuse_lexer, ss);
+    stylesheet_optimize(ss);
+    test_minify_stylesheet(ss, "b{color:red;margin:0}", 21);
+    stylesheet_stats(ss, &stats);
+
+    if (stats.mallocs != 0) {
+        fail("Expected a reused stylesheet to need no mallocs but got %zu\n", stats.mallocs);
+    } else {
+        passes++;
+    }
 
+    stylesheet_free(ss);
+    lexer_free(reuse_lexer);
+    lexer_free(lexer);
+    free(data);
 }
 
 void ranges() {
@@ -232,6 +1136,22 @@ int main(int argc, const char * argv[])
     ranges();
     numbers();
     tokens();
+    atoms();
+    keywords();
+    memory();
+    utf8();
+    arena();
+    output();
+    runs();
+    comments();
+    stress();
+    threaded();
+    parallel();
+    tape();
+    errors();
+    minify();
+    numeric();
+    colors();
 
     parse("@media all { /* c */ a img { color: inherit; } /* d */ } th, td { /* ns 4 */ font-family: sans-serif; }");
     //parse("foo { }");
@@ -239,5 +1159,5 @@ int main(int argc, const char * argv[])
     //parse("foo { color: rgb(255, 200, 0); }");
 
     printf("passed: %d failed: %d\n", passes, fails);
-    return 0;
+    return fails ? EXIT_FAILURE : EXIT_SUCCESS;
 }
@@ -0,0 +1,139 @@
+#!/usr/bin/env python3
+# Writes crush/keywords.h, the keywords crush.c recognizes and a perfect hash
+# to find them with, from the list in tools/keywords.txt:
+#
+#     python3 tools/keywords.py tools/keywords.txt > crush/keywords.h
+#
+# The hash of a name is FNV-1a over its bytes folded to ASCII lower case, the
+# same hash atoms are interned with. Its low bits pick a bucket, and the
+# bucket's displacement d places each of its keywords at slot
+# ((hash ^ d) * 0x9E3779B1) >> (32 - SLOT_BITS). Displacements are chosen,
+# biggest bucket first, so that no two keywords share a slot; a name is then a
+# keyword only if it equals the one keyword in its slot.
+
+import re
+import sys
+
+KINDS = {
+    "properties": "KEYWORD_PROPERTY",
+    "at-rules": "KEYWORD_AT_RULE",
+    "units": "KEYWORD_UNIT",
+    "pseudo-classes": "KEYWORD_PSEUDO_CLASS",
+    "functions": "KEYWORD_FUNCTION",
+    "values": "KEYWORD_VALUE",
+}
+FLAGS = {
+    "length": "KEYWORD_LENGTH",
+    "colors": "KEYWORD_COLORS",
+}
+MASK = 0xFFFFFFFF
+
+
+def read(path):
+    keywords = {}
+    kind = None
+    for number, line in enumerate(open(path), 1):
+        line = line.split("#", 1)[0].split()
+        if not line:
+            continue
+        section = re.fullmatch(r"\[(.*)\]", line[0])
+        if section:
+            kind = KINDS[section.group(1)]
+            continue
+        name, flags = line[0], line[1:]
+        if kind is None or name != name.lower() or any(f not in FLAGS for f in flags):
+            sys.exit("%s:%d: bad keyword line" % (path, number))
+        keywords.setdefault(name, set()).update([kind] + [FLAGS[f] for f in flags])
+    return keywords
+
+
+def fnv1a(name):
+    hash = 2166136261
+    for byte in name.encode():
+        hash = ((hash ^ byte) * 16777619) & MASK
+    return hash
+
+
+def perfect_hash(names):
+    slot_bits = (2 * len(names) - 1).bit_length()
+    buckets = 1 << max(slot_bits - 2, 0)
+
+    by_bucket = [[] for _ in range(buckets)]
+    for name in names:
+        by_bucket[fnv1a(name) & (buckets - 1)].append(name)
+
+    slots = [None] * (1 << slot_bits)
+    displacements = [0] * buckets
+    for bucket in sorted(range(buckets), key=lambda b: -len(by_bucket[b])):
+        members = by_bucket[bucket]
+        if not members:
+            break
+        for d in range(1 << 24):
+            placed = [(((fnv1a(n) ^ d) * 0x9E3779B1) & MASK) >> (32 - slot_bits) for n in members]
+            if len(set(placed)) == len(placed) and all(slots[s] is None for s in placed):
+                break
+        else:
+            sys.exit("no displacement places bucket %d" % bucket)
+        displacements[bucket] = d
+        for name, slot in zip(members, placed):
+            slots[slot] = name
+    return slot_bits, buckets, displacements, slots
+
+
+def atom(name):
+    return "ATOM_" + name.strip("-").replace("-", "_").upper()
+
+
+def main():
+    keywords = read(sys.argv[1])
+    names = sorted(keywords)
+    atoms = [atom(n) for n in names]
+    if len(set(atoms)) != len(atoms):
+        sys.exit("keywords with the same atom name")
+    slot_bits, buckets, displacements, slots = perfect_hash(names)
+
+    width = max(len(a) for a in atoms) + 1
+    print("// Generated by tools/keywords.py from tools/keywords.txt. Do not edit.")
+    print("#pragma once")
+    print("#include <stdint.h>")
+    print()
+    print("enum keyword_flags {")
+    for i, flag in enumerate(list(KINDS.values()) + list(FLAGS.values())):
+        print("    %s = 1 << %d," % (flag, i))
+    print("};")
+    print()
+    print("enum atom {")
+    print("    NO_ATOM,")
+    for a in atoms:
+        print("    %s," % a)
+    print("    ATOM_KEYWORD_COUNT")
+    print("};")
+    print()
+    print("struct keyword {")
+    print("    const char* name;")
+    print("    unsigned char length;")
+    print("    unsigned short flags;")
+    print("};")
+    print()
+    print("static const struct keyword keywords[] = {")
+    print("    %s = {\"\", 0, 0}," % "[NO_ATOM]".ljust(width + 2))
+    for name, a in zip(names, atoms):
+        flags = " | ".join(sorted(keywords[name], key=lambda f: f.split("_", 1)[1]))
+        print("    %s = {\"%s\", %d, %s}," % (("[%s]" % a).ljust(width + 2), name, len(name), flags))
+    print("};")
+    print()
+    print("enum { KEYWORD_SLOT_BITS = %d, KEYWORD_BUCKETS = %d };" % (slot_bits, buckets))
+    print()
+    print("static const uint32_t keyword_displacements[KEYWORD_BUCKETS] = {")
+    for i in range(0, buckets, 8):
+        print("    " + " ".join("%d," % d for d in displacements[i:i + 8]))
+    print("};")
+    print()
+    print("static const unsigned short keyword_slots[1 << KEYWORD_SLOT_BITS] = {")
+    for slot, name in enumerate(slots):
+        if name:
+            print("    [%d] = %s," % (slot, atom(name)))
+    print("};")
+
+
+main()
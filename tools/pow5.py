@@ -0,0 +1,44 @@
+#!/usr/bin/env python3
+# Writes crush/pow5.h, the table of powers of five that string_to_number in
+# crush.c converts decimal numbers with:
+#
+#     python3 tools/pow5.py > crush/pow5.h
+#
+# Entry q - POW5_MIN holds 5^q for q in [POW5_MIN, POW5_MAX], scaled by a
+# power of two so that its top bit is bit 127, as two 64 bit halves. Powers
+# that do not fit are truncated; negative powers are rounded up.
+
+POW5_MIN = -342
+POW5_MAX = 308
+
+
+def normalized(q):
+    if q >= 0:
+        power = 5 ** q
+        while power < 1 << 127:
+            power *= 2
+        while power >= 1 << 128:
+            power //= 2
+        return power
+
+    power = 5 ** -q
+    z = power.bit_length()
+    if q >= -27:
+        return 2 ** (z + 127) // power + 1
+    result = 2 ** (2 * z + 128) // power + 1
+    while result >= 1 << 128:
+        result //= 2
+    return result
+
+
+print("// Generated by tools/pow5.py. Do not edit.")
+print("#pragma once")
+print("#include <stdint.h>")
+print()
+print("enum { POW5_MIN = %d, POW5_MAX = %d };" % (POW5_MIN, POW5_MAX))
+print()
+print("static const uint64_t pow5[%d][2] = {" % (POW5_MAX - POW5_MIN + 1))
+for q in range(POW5_MIN, POW5_MAX + 1):
+    n = normalized(q)
+    print("    {0x%016XU, 0x%016XU}, // 5^%d" % (n >> 64, n & ((1 << 64) - 1), q))
+print("};")